@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "Benchmark.h"
+#include "BoundingBoxSoA.h"
+
+// Physics and geometry microbenchmarks. No window or GL context is needed.
+//
+// Usage: BattleBeyzBench [--filter TEXT] [--json FILE] [--model OBJ]
+//
+// --filter runs only the cases whose name contains TEXT, e.g. "world_update" or "bodies=1024".
+// --json writes every result, with the build and CPU it ran on, for comparing runs between releases.
+// --model is the OBJ used by the model benchmarks, beyblade.obj from the assets by default.
+
+namespace {
+    struct Options {
+        std::string filter;
+        std::string jsonPath;
+        std::string modelPath = "../assets/images/beyblade.obj";
+    };
+
+    void printUsage() {
+        std::printf("Usage: BattleBeyzBench [--filter TEXT] [--json FILE] [--model OBJ]\n");
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            if (std::strcmp(arg, "--help") == 0 || i + 1 >= argc) {
+                return false;
+            }
+            const char* value = argv[++i];
+            if (std::strcmp(arg, "--filter") == 0) options.filter = value;
+            else if (std::strcmp(arg, "--json") == 0) options.jsonPath = value;
+            else if (std::strcmp(arg, "--model") == 0) options.modelPath = value;
+            else return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    std::printf("Best SIMD level: %s\n", simdLevelName(detectSimdLevel()));
+    BenchmarkSuite suite(options.filter);
+    runOverlapBenchmarks(suite);
+    runWorldBenchmarks(suite);
+    runGeometryBenchmarks(suite, options.modelPath);
+    runRollbackBenchmarks(suite);
+
+    if (suite.getResults().empty()) {
+        std::printf("No benchmark matches \"%s\"\n", options.filter.c_str());
+        return 1;
+    }
+    if (!options.jsonPath.empty() && !suite.writeJson(options.jsonPath)) {
+        return 1;
+    }
+    return 0;
+}
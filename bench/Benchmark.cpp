@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include "Benchmark.h"
+#include "BoundingBoxSoA.h"
+
+bool BenchmarkSuite::enabled(const std::string& name) const {
+    return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+void BenchmarkSuite::record(const std::string& name, std::vector<double>& nsPerOp, double opsPerSample) {
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+    BenchmarkResult result{name, nsPerOp[nsPerOp.size() / 2], nsPerOp.front(), opsPerSample,
+                           static_cast<int>(nsPerOp.size())};
+    results.push_back(result);
+    std::printf("%-48s %14.1f ns/op  (min %.1f, %d samples)\n", name.c_str(), result.nsPerOp, result.minNsPerOp,
+                result.samples);
+    std::fflush(stdout);
+}
+
+bool BenchmarkSuite::writeJson(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::fprintf(stderr, "Could not write %s\n", path.c_str());
+        return false;
+    }
+
+#ifdef NDEBUG
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+#if defined(__clang__)
+    const char* compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    const char* compiler = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    const char* compiler = "msvc";
+#else
+    const char* compiler = "unknown";
+#endif
+
+    // Names are generated here and never need escaping
+    std::fprintf(file, "{\n");
+    std::fprintf(file, "  \"format\": 1,\n");
+    std::fprintf(file, "  \"timestamp\": %lld,\n", static_cast<long long>(std::time(nullptr)));
+    std::fprintf(file, "  \"build\": \"%s\",\n", build);
+    std::fprintf(file, "  \"compiler\": \"%s\",\n", compiler);
+    std::fprintf(file, "  \"simd\": \"%s\",\n", simdLevelName(detectSimdLevel()));
+    std::fprintf(file, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        std::fprintf(file, "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, "
+                           "\"ops_per_sample\": %.0f, \"samples\": %d}%s\n",
+                     r.name.c_str(), r.nsPerOp, r.minNsPerOp, r.opsPerSample, r.samples,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    std::fclose(file);
+    return true;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+struct BenchmarkResult {
+    std::string name;       // group/case, e.g. "world_update/bodies=64"
+    double nsPerOp;         // Median over the samples
+    double minNsPerOp;
+    double opsPerSample;
+    int samples;
+};
+
+// Runs named measurements, prints them as they finish and collects them for the JSON report.
+// Names not containing the filter are skipped without running.
+class BenchmarkSuite {
+public:
+    static constexpr int kSamples = 5;
+    static constexpr double kMinSampleSeconds = 0.02;
+
+    explicit BenchmarkSuite(std::string filter) : filter(std::move(filter)) {}
+
+    [[nodiscard]] bool enabled(const std::string& name) const;
+
+    // For work that can repeat on the same state: fn does opsPerCall operations and is called in a loop,
+    // doubling the count until a sample is long enough to trust
+    template<typename F>
+    void measure(const std::string& name, double opsPerCall, F&& fn);
+
+    // For work that consumes its state: setup runs untimed before every sample, then run once
+    template<typename Setup, typename Run>
+    void measureEach(const std::string& name, double opsPerSample, Setup&& setup, Run&& run);
+
+    [[nodiscard]] const std::vector<BenchmarkResult>& getResults() const { return results; }
+    bool writeJson(const std::string& path) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::string filter;
+    std::vector<BenchmarkResult> results;
+
+    void record(const std::string& name, std::vector<double>& nsPerOp, double opsPerSample);
+};
+
+template<typename F>
+void BenchmarkSuite::measure(const std::string& name, double opsPerCall, F&& fn) {
+    if (!enabled(name)) return;
+
+    // Calibrate once, then take every sample at that repeat count
+    size_t rounds = 1;
+    while (true) {
+        auto start = Clock::now();
+        for (size_t r = 0; r < rounds; ++r) fn();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds >= kMinSampleSeconds || rounds >= (size_t(1) << 24)) break;
+        rounds *= 2;
+    }
+
+    std::vector<double> nsPerOp;
+    double opsPerSample = opsPerCall * static_cast<double>(rounds);
+    for (int sample = 0; sample < kSamples; ++sample) {
+        auto start = Clock::now();
+        for (size_t r = 0; r < rounds; ++r) fn();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        nsPerOp.push_back(ns / opsPerSample);
+    }
+    record(name, nsPerOp, opsPerSample);
+}
+
+template<typename Setup, typename Run>
+void BenchmarkSuite::measureEach(const std::string& name, double opsPerSample, Setup&& setup, Run&& run) {
+    if (!enabled(name)) return;
+
+    std::vector<double> nsPerOp;
+    for (int sample = 0; sample < kSamples; ++sample) {
+        setup();
+        auto start = Clock::now();
+        run();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        nsPerOp.push_back(ns / opsPerSample);
+    }
+    record(name, nsPerOp, opsPerSample);
+}
+
+// Benchmark groups, one per file
+void runOverlapBenchmarks(BenchmarkSuite& suite);
+void runWorldBenchmarks(BenchmarkSuite& suite);
+void runGeometryBenchmarks(BenchmarkSuite& suite, const std::string& modelPath);
+void runRollbackBenchmarks(BenchmarkSuite& suite);
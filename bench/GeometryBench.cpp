@@ -0,0 +1,81 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "Benchmark.h"
+#include "ObjLoader.h"
+#include "StadiumGeometry.h"
+#include "TriangleBVH.h"
+
+// Mesh generation and loading: the stadium bowl at several resolutions, with and without its per-triangle
+// collision boxes, and the beyblade model's load, pick tree build and picks.
+
+void runGeometryBenchmarks(BenchmarkSuite& suite, const std::string& modelPath) {
+    struct Resolution {
+        int rings;
+        int sections;
+    };
+    for (Resolution resolution : {Resolution{10, 64}, Resolution{20, 128}, Resolution{40, 256}}) {
+        std::string suffix = "/rings=" + std::to_string(resolution.rings) +
+                             ",sections=" + std::to_string(resolution.sections);
+
+        StadiumGeometry geometry;
+        suite.measure("stadium_generate" + suffix, 1.0, [&]() {
+            geometry.generate(4.0f, 0.02f, resolution.rings, resolution.sections);
+        });
+        if (geometry.vertices.empty()) geometry.generate(4.0f, 0.02f, resolution.rings, resolution.sections);
+
+        suite.measure("stadium_collision_boxes" + suffix, 1.0, [&]() {
+            std::shared_ptr<const StaticGeometry> collision = geometry.createStaticGeometry(glm::vec3(0.0f));
+        });
+    }
+
+    std::string modelName = modelPath.substr(modelPath.find_last_of("/\\") + 1);
+    std::string modelSuffix = "/" + modelName;
+    if (!suite.enabled("obj_load" + modelSuffix) && !suite.enabled("mesh_pick_build" + modelSuffix) &&
+        !suite.enabled("mesh_pick" + modelSuffix)) {
+        return;
+    }
+
+    ObjMesh mesh;
+    if (!loadObjMesh(modelPath, mesh, false)) {
+        std::fprintf(stderr, "Skipping model benchmarks, %s did not load (see --model)\n", modelPath.c_str());
+        return;
+    }
+
+    suite.measure("obj_load" + modelSuffix, 1.0, [&]() {
+        ObjMesh loaded;
+        loadObjMesh(modelPath, loaded, false);
+    });
+
+    TriangleBVH tree;
+    suite.measure("mesh_pick_build" + modelSuffix, 1.0, [&]() {
+        tree.build(mesh.vertices, mesh.indices);
+    });
+    if (tree.empty()) tree.build(mesh.vertices, mesh.indices);
+
+    // Rays from all around the model towards points inside its bounds, about the mix a hovering cursor gives
+    BoundingBox bounds;
+    for (const glm::vec3& v : mesh.vertices) bounds.expandToInclude(v);
+    glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
+    float reach = glm::length(bounds.max - bounds.min);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<glm::vec3> origins(256), directions(256);
+    for (size_t i = 0; i < origins.size(); ++i) {
+        glm::vec3 away = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)));
+        glm::vec3 target = center + glm::vec3(unit(rng), unit(rng), unit(rng)) * (bounds.max - bounds.min) * 0.5f;
+        origins[i] = center + away * reach;
+        directions[i] = glm::normalize(target - origins[i]);
+    }
+
+    volatile size_t sink = 0;
+    suite.measure("mesh_pick" + modelSuffix, static_cast<double>(origins.size()), [&]() {
+        size_t hits = 0;
+        TriangleHit hit;
+        for (size_t i = 0; i < origins.size(); ++i) {
+            hits += tree.raycast(origins[i], directions[i], 1e30f, hit) ? 1 : 0;
+        }
+        sink = sink + hits;
+    });
+}
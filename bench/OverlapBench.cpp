@@ -0,0 +1,62 @@
+#include <random>
+#include <string>
+#include <vector>
+#include "Benchmark.h"
+#include "BoundingBox.h"
+#include "BoundingBoxSoA.h"
+
+// Compares the per-box BoundingBox::checkCollision loop against the SoA overlap kernels at every SIMD level
+// the CPU supports. One op is one query box tested against one candidate.
+
+namespace {
+    std::vector<BoundingBox> makeBoxes(size_t count, std::mt19937& rng) {
+        std::uniform_real_distribution<float> position(-4.0f, 4.0f);
+        std::uniform_real_distribution<float> size(0.02f, 0.3f);
+        std::vector<BoundingBox> boxes;
+        boxes.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec3 center(position(rng), position(rng) * 0.1f, position(rng));
+            glm::vec3 half(size(rng), size(rng), size(rng));
+            boxes.emplace_back(center - half, center + half);
+        }
+        return boxes;
+    }
+}
+
+void runOverlapBenchmarks(BenchmarkSuite& suite) {
+    std::mt19937 rng(1234);
+    std::vector<BoundingBox> queries = makeBoxes(256, rng);
+    volatile size_t sink = 0;
+
+    for (size_t count : {8, 64, 1216, 20224}) {
+        std::vector<BoundingBox> boxes = makeBoxes(count, rng);
+        BoundingBoxSoA set;
+        set.assign(boxes);
+        std::vector<uint32_t> masks(set.maskWords());
+        double ops = static_cast<double>(count * queries.size());
+        std::string suffix = "/boxes=" + std::to_string(count);
+
+        suite.measure("box_overlap/check_collision" + suffix, ops, [&]() {
+            size_t hits = 0;
+            for (const auto& query : queries) {
+                for (const auto& box : boxes) {
+                    hits += query.checkCollision(box) ? 1 : 0;
+                }
+            }
+            sink = sink + hits;
+        });
+
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (static_cast<int>(level) > static_cast<int>(detectSimdLevel())) continue;
+            setSimdLevel(level);
+            suite.measure(std::string("box_overlap/soa_") + simdLevelName(level) + suffix, ops, [&]() {
+                size_t hits = 0;
+                for (const auto& query : queries) {
+                    hits += set.overlapMask(query, masks.data());
+                }
+                sink = sink + hits;
+            });
+        }
+        setSimdLevel(detectSimdLevel());
+    }
+}
@@ -0,0 +1,56 @@
+#include <string>
+#include "Benchmark.h"
+#include "Match.h"
+
+// The rollback netcode's worst case: restore a match and simulate a full prediction window again within one
+// displayed frame. Each frame is what RollbackSession does per resimulated frame: save the state, checksum it,
+// then run the physics steps with new inputs. At 60 frames per second this has to stay well under 16.7 ms.
+
+namespace {
+    constexpr int kRollbackFrames = 8;
+    constexpr int kStepsPerFrame = 4;
+    constexpr int kWarmupSteps = 120;
+
+    void benchRollback(BenchmarkSuite& suite, const MatchSettings& settings, const std::string& stadium) {
+        std::string name = "rollback_resimulate/frames=" + std::to_string(kRollbackFrames) + ",stadium=" + stadium;
+        if (!suite.enabled(name)) return;
+
+        BeybladeConfig configs[2];
+        configs[0].mass = 1.1f;
+        configs[0].spinDecay = 25.0f;
+        configs[1].mass = 0.9f;
+        configs[1].spinDecay = 15.0f;
+        LaunchParameters launches[2];
+        randomLaunches(1, settings, configs, launches);
+
+        // Roll back from the middle of the match, once the tops are moving and have contacts cached
+        Match match(settings, configs, launches);
+        for (int i = 0; i < kWarmupSteps; ++i) match.step();
+        MatchSnapshot start;
+        match.snapshot(start);
+
+        MatchSnapshot frames[kRollbackFrames];
+        volatile uint64_t sink = 0;
+        suite.measure(name, 1.0, [&]() {
+            match.restore(start);
+            for (int f = 0; f < kRollbackFrames; ++f) {
+                match.snapshot(frames[f]);
+                sink = sink + worldChecksum(match.getWorld());
+                match.setInput(0, PlayerInput{static_cast<uint8_t>(f & 3 ? PlayerInput::Left : PlayerInput::Forward)});
+                match.setInput(1, PlayerInput{PlayerInput::Right});
+                for (int s = 0; s < kStepsPerFrame; ++s) match.step();
+            }
+        });
+    }
+}
+
+void runRollbackBenchmarks(BenchmarkSuite& suite) {
+    MatchSettings analytic;
+    benchRollback(suite, analytic, "analytic");
+
+    MatchSettings mesh;
+    mesh.analyticStadium = false;
+    mesh.numRings = 20;
+    mesh.verticesPerRing = 128;
+    benchRollback(suite, mesh, "mesh_20x128");
+}
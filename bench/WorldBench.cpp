@@ -0,0 +1,117 @@
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Benchmark.h"
+#include "PhysicsWorld.h"
+
+// Full PhysicsWorld::update steps on a bowl of spinning tops, snapshots of it, and the spatial queries against it.
+// The bowl widens with the body count so the crowd density stays about the same.
+
+namespace {
+    constexpr float kStepsPerSecond = 240.0f;
+    constexpr int kWarmupSteps = 30;
+    constexpr int kTimedSteps = 240;
+
+    void buildScene(PhysicsWorld& world, int bodyCount, unsigned seed) {
+        world.clear();
+        world.gravity = glm::vec3(0.0f, -9.81f, 0.0f);
+
+        float radius = std::max(4.0f, 0.6f * std::sqrt(static_cast<float>(bodyCount)));
+        float curvature = 0.5f / (radius * radius);  // Rim stays half a meter high
+        float rimHeight = curvature * radius * radius;
+        RigidBody* stadium = world.getBody(world.createImmovableBody(glm::vec3(0.0f), glm::vec3(radius * 2.0f)));
+        BoundingBox bowlBounds(glm::vec3(-radius, -rimHeight, -radius), glm::vec3(radius, rimHeight, radius));
+        stadium->setStaticGeometry(StaticGeometry::create(glm::vec3(0.0f), {bowlBounds}, false,
+                                                          std::make_shared<StadiumCollider>(glm::vec3(0.0f), radius, curvature)));
+
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        glm::vec3 half(0.3f, 0.1f, 0.3f);
+        for (int i = 0; i < bodyCount; ++i) {
+            float angle = unit(rng) * 6.2831853f;
+            float r = std::sqrt(unit(rng)) * radius * 0.8f;
+            glm::vec3 position(r * std::cos(angle), curvature * r * r + 0.3f, r * std::sin(angle));
+            RigidBody* top = world.getBody(world.createBody(position, half * 2.0f, 1.0f));
+            top->localBoxes.emplace_back(-half, half);
+            top->updateBoundingBoxes();
+            top->velocity = glm::vec3(-std::sin(angle), 0.0f, std::cos(angle)) * (1.0f + 2.0f * unit(rng));
+            top->angularVelocity = glm::vec3(0.0f, 150.0f + 100.0f * unit(rng), 0.0f);
+            top->spinFriction = 20.0f;
+            top->friction = 0.05f;
+            top->shape = {ShapeType::Disc, 0.3f};
+            top->continuousCollision = true;
+        }
+    }
+}
+
+void runWorldBenchmarks(BenchmarkSuite& suite) {
+    PhysicsWorld world;
+    float dt = 1.0f / kStepsPerSecond;
+
+    for (int bodies : {2, 8, 32, 128, 512, 1024}) {
+        std::string suffix = "/bodies=" + std::to_string(bodies);
+
+        // One op is one step. Every sample replays the same steps from a freshly built scene.
+        suite.measureEach("world_update" + suffix, kTimedSteps,
+                          [&]() {
+                              buildScene(world, bodies, 7);
+                              for (int i = 0; i < kWarmupSteps; ++i) world.update(dt);
+                          },
+                          [&]() {
+                              for (int i = 0; i < kTimedSteps; ++i) world.update(dt);
+                          });
+
+        // Copying the scene's state out and back in, once it has contacts cached
+        if (!suite.enabled("world_snapshot" + suffix) && !suite.enabled("world_restore" + suffix)) continue;
+        buildScene(world, bodies, 7);
+        for (int i = 0; i < kWarmupSteps; ++i) world.update(dt);
+        PhysicsSnapshot snapshot;
+        world.snapshot(snapshot);
+        suite.measure("world_snapshot" + suffix, 1.0, [&]() { world.snapshot(snapshot); });
+        suite.measure("world_restore" + suffix, 1.0, [&]() { world.restore(snapshot); });
+    }
+
+    // Queries against a settled 1024 body scene, 256 different queries per call
+    std::string querySuffix = "/bodies=1024";
+    bool anyQuery = suite.enabled("query/aabb" + querySuffix) || suite.enabled("query/sphere" + querySuffix) ||
+                    suite.enabled("query/raycast" + querySuffix);
+    if (!anyQuery) return;
+
+    buildScene(world, 1024, 7);
+    for (int i = 0; i < kWarmupSteps; ++i) world.update(dt);
+
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> spread(-20.0f, 20.0f);
+    std::vector<glm::vec3> points(256), directions(256);
+    for (size_t i = 0; i < points.size(); ++i) {
+        points[i] = glm::vec3(spread(rng), 2.0f + 0.1f * spread(rng), spread(rng));
+        directions[i] = glm::vec3(spread(rng), -10.0f, spread(rng));
+    }
+
+    RigidBody* results[64];
+    volatile size_t sink = 0;
+    suite.measure("query/aabb" + querySuffix, static_cast<double>(points.size()), [&]() {
+        size_t found = 0;
+        for (const glm::vec3& p : points) {
+            found += world.queryAABB(BoundingBox(p - 1.0f, p + 1.0f), results, 64);
+        }
+        sink = sink + found;
+    });
+    suite.measure("query/sphere" + querySuffix, static_cast<double>(points.size()), [&]() {
+        size_t found = 0;
+        for (const glm::vec3& p : points) {
+            found += world.overlapSphere(p, 1.0f, results, 64);
+        }
+        sink = sink + found;
+    });
+    suite.measure("query/raycast" + querySuffix, static_cast<double>(points.size()), [&]() {
+        size_t found = 0;
+        RaycastHit hit;
+        for (size_t i = 0; i < points.size(); ++i) {
+            found += world.raycast(points[i] + glm::vec3(0.0f, 10.0f, 0.0f), directions[i], 100.0f, hit) ? 1 : 0;
+        }
+        sink = sink + found;
+    });
+}
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include "Match.h"
+#include "RollbackSession.h"
+
+// Rollback netcode soak test. Two peers play one match over a simulated network with latency and packet loss,
+// each with its own Match and RollbackSession, on scripted random inputs. Every confirmed frame's checksum is
+// checked against a reference run of the same inputs without any netcode, and the rollbacks are timed against
+// a 60 Hz frame.
+//
+// Usage: BattleBeyzNetplay [--frames N] [--latency FRAMES] [--loss PERCENT] [--delay FRAMES]
+//                          [--prediction FRAMES] [--steps-per-frame N] [--seed S] [--mesh-stadium]
+//
+// --latency is one way, in frames. --delay is the input delay and --prediction how far a peer may run ahead of
+// the inputs it has, see RollbackSettings. Exits with 2 if a peer diverged from the reference.
+
+namespace {
+    constexpr double kFrameBudgetSeconds = 1.0 / 60.0;
+
+    struct Options {
+        uint32_t frames = 1200;
+        uint32_t latency = 4;
+        float loss = 0.0f;
+        unsigned seed = 1;
+        RollbackSettings rollback;
+        MatchSettings settings;
+    };
+
+    void printUsage() {
+        std::printf("Usage: BattleBeyzNetplay [--frames N] [--latency FRAMES] [--loss PERCENT] [--delay FRAMES] "
+                    "[--prediction FRAMES] [--steps-per-frame N] [--seed S] [--mesh-stadium]\n");
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            if (std::strcmp(arg, "--mesh-stadium") == 0) {
+                options.settings.analyticStadium = false;
+                continue;
+            }
+            if (std::strcmp(arg, "--help") == 0 || i + 1 >= argc) {
+                return false;
+            }
+            const char* value = argv[++i];
+            auto count = [&]() { return static_cast<uint32_t>(std::strtoul(value, nullptr, 10)); };
+            if (std::strcmp(arg, "--frames") == 0) options.frames = count();
+            else if (std::strcmp(arg, "--latency") == 0) options.latency = count();
+            else if (std::strcmp(arg, "--loss") == 0) options.loss = static_cast<float>(std::atof(value));
+            else if (std::strcmp(arg, "--delay") == 0) options.rollback.inputDelay = count();
+            else if (std::strcmp(arg, "--prediction") == 0) options.rollback.maxPrediction = count();
+            else if (std::strcmp(arg, "--steps-per-frame") == 0) options.rollback.stepsPerFrame = count();
+            else if (std::strcmp(arg, "--seed") == 0) options.seed = count();
+            else return false;
+        }
+        return options.frames > 0 && options.rollback.stepsPerFrame > 0 && options.loss >= 0.0f &&
+               options.loss < 100.0f;
+    }
+
+    // Each player holds a random direction for a random number of frames, then picks another
+    std::vector<PlayerInput> scriptInputs(std::mt19937& rng, uint32_t frames) {
+        std::uniform_int_distribution<int> buttons(0, 15);
+        std::uniform_int_distribution<uint32_t> hold(5, 40);
+        std::vector<PlayerInput> script;
+        while (script.size() < frames) {
+            PlayerInput input{static_cast<uint8_t>(buttons(rng))};
+            script.insert(script.end(), hold(rng), input);
+        }
+        script.resize(frames);
+        return script;
+    }
+
+    void printPeer(int peer, const RollbackStats& stats) {
+        std::printf("Peer %d:           %u rollbacks, %u frames resimulated, longest %u frames, %u stalls\n", peer,
+                    stats.rollbacks, stats.resimulatedFrames, stats.maxRollbackFrames, stats.stalledFrames);
+        std::printf("                  %.3f ms mean, %.3f ms max per rollback, %u packets sent, %u received\n",
+                    stats.rollbacks > 0 ? 1e3 * stats.rollbackSeconds / stats.rollbacks : 0.0,
+                    1e3 * stats.maxRollbackSeconds, stats.packetsSent, stats.packetsReceived);
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    BeybladeConfig configs[2];
+    configs[0].name = "Attack";
+    configs[0].mass = 1.1f;
+    configs[0].spinDecay = 25.0f;
+    configs[1].name = "Stamina";
+    configs[1].mass = 0.9f;
+    configs[1].spinDecay = 15.0f;
+    LaunchParameters launches[2];
+    randomLaunches(options.seed, options.settings, configs, launches);
+    std::shared_ptr<const StaticGeometry> stadiumGeometry = createStadiumGeometry(options.settings);
+
+    // Once both peers have played every scripted frame they carry on with empty inputs until every frame is
+    // confirmed, so the reference runs a history's worth further
+    uint32_t referenceFrames = options.frames + RollbackSession::kHistory;
+    std::mt19937 rng(options.seed);
+    std::vector<PlayerInput> scripts[2];
+    for (auto& script : scripts) {
+        script = scriptInputs(rng, options.frames);
+        script.resize(referenceFrames);
+    }
+
+    // What both peers should see: frame f runs on the inputs read inputDelay frames earlier
+    uint32_t inputDelay = std::min(options.rollback.inputDelay, 8u);
+    Match reference(options.settings, configs, launches, stadiumGeometry);
+    std::vector<uint64_t> expected(referenceFrames + 1);
+    for (uint32_t f = 0; f <= referenceFrames; ++f) {
+        expected[f] = worldChecksum(reference.getWorld());
+        if (f == referenceFrames) break;
+        for (int player = 0; player < 2; ++player) {
+            reference.setInput(player, f < inputDelay ? PlayerInput{} : scripts[player][f - inputDelay]);
+        }
+        for (uint32_t s = 0; s < options.rollback.stepsPerFrame; ++s) reference.step();
+    }
+
+    LoopbackPipe pipe(options.latency, options.loss, options.seed);
+    std::unique_ptr<Match> matches[2];
+    std::unique_ptr<RollbackSession> sessions[2];
+    for (int peer = 0; peer < 2; ++peer) {
+        matches[peer] = std::make_unique<Match>(options.settings, configs, launches, stadiumGeometry);
+        sessions[peer] = std::make_unique<RollbackSession>(*matches[peer], peer, pipe.endpoint(peer), options.rollback);
+    }
+
+    // Both peers run in this thread, one frame each per tick of the pipe
+    uint32_t verified[2] = {0, 0};
+    uint32_t mismatchFrame = UINT32_MAX;
+    int mismatchPeer = -1;
+    uint32_t ticks = 0;
+    uint32_t maxTicks = 20 * referenceFrames;
+    while ((verified[0] <= options.frames || verified[1] <= options.frames) && ticks < maxTicks) {
+        for (int peer = 0; peer < 2; ++peer) {
+            RollbackSession& session = *sessions[peer];
+            uint32_t frame = session.getFrame();
+            if (frame >= referenceFrames) continue;
+            session.advanceFrame(frame < options.frames ? scripts[peer][frame] : PlayerInput{});
+
+            uint64_t checksum;
+            while (verified[peer] < session.getConfirmedFrame() && session.getChecksum(verified[peer], checksum)) {
+                if (checksum != expected[verified[peer]] && verified[peer] < mismatchFrame) {
+                    mismatchFrame = verified[peer];
+                    mismatchPeer = peer;
+                }
+                verified[peer]++;
+            }
+        }
+        pipe.tick();
+        ticks++;
+    }
+
+    std::printf("Netplay:          %u frames at %u steps each, %u frame latency, %.1f%% loss, %u frame delay, "
+                "%u frame prediction\n", options.frames, options.rollback.stepsPerFrame, options.latency,
+                options.loss, inputDelay, options.rollback.maxPrediction);
+    printPeer(0, sessions[0]->getStats());
+    printPeer(1, sessions[1]->getStats());
+
+    double worstRollback = std::max(sessions[0]->getStats().maxRollbackSeconds,
+                                    sessions[1]->getStats().maxRollbackSeconds);
+    std::printf("Rollback budget:  worst %.3f ms of a %.1f ms frame (%.0f%%)\n", 1e3 * worstRollback,
+                1e3 * kFrameBudgetSeconds, 100.0 * worstRollback / kFrameBudgetSeconds);
+
+    const MatchResult& result = matches[0]->getResult();
+    std::printf("Outcome:          %s, %s\n", matchOutcomeName(result.outcome),
+                result.winner >= 0 ? configs[result.winner].name.c_str() : "no winner");
+
+    for (int peer = 0; peer < 2; ++peer) {
+        uint32_t desync = sessions[peer]->getStats().desyncFrame;
+        if (desync != UINT32_MAX) {
+            std::printf("Diverged:         peer %d saw a checksum mismatch with the other at frame %u\n", peer, desync);
+            return 2;
+        }
+    }
+    if (mismatchPeer >= 0) {
+        std::printf("Diverged:         peer %d differs from the reference at frame %u\n", mismatchPeer, mismatchFrame);
+        return 2;
+    }
+    if (verified[0] <= options.frames || verified[1] <= options.frames) {
+        std::printf("Stalled:          only %u and %u frames confirmed after %u ticks\n", verified[0], verified[1],
+                    ticks);
+        return 2;
+    }
+    std::printf("Checksums:        %u frames verified on each peer against the reference\n", options.frames + 1);
+    return 0;
+}
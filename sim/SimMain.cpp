@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "JobSystem.h"
+#include "Match.h"
+
+// Headless match runner. Plays N matches between two tops with randomised launches, spread over every core,
+// and prints throughput and outcome statistics. No window, GL context or ImGui is involved.
+//
+// Usage: BattleBeyzSim [--matches N] [--seed S] [--threads T] [--duration SECONDS] [--rate HZ] [--rings R]
+//                      [--sections S] [--iterations N] [--position-iterations N] [--mesh-stadium] [--record FILE]
+//        BattleBeyzSim --replay FILE [--threads T]
+//
+// --mesh-stadium collides against the per-triangle boxes instead of the exact bowl.
+// --iterations and --position-iterations set the contact solver's budget, to trade accuracy against step time.
+// --record saves the first match as a replay log. --replay plays a log recorded here or in the game, checks its
+// checksums and reports step timing, so a recorded session doubles as a repeatable workload.
+
+namespace {
+    struct Options {
+        int matches = 100;
+        unsigned seed = 1;
+        unsigned threads = 0;  // 0 uses every hardware thread
+        const char* recordPath = nullptr;
+        const char* replayPath = nullptr;
+        MatchSettings settings;
+    };
+
+    void printUsage() {
+        std::printf("Usage: BattleBeyzSim [--matches N] [--seed S] [--threads T] [--duration SECONDS] "
+                    "[--rate HZ] [--rings R] [--sections S] [--iterations N] [--position-iterations N] "
+                    "[--mesh-stadium] [--record FILE]\n"
+                    "       BattleBeyzSim --replay FILE [--threads T]\n");
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            if (std::strcmp(arg, "--mesh-stadium") == 0) {
+                options.settings.analyticStadium = false;
+                continue;
+            }
+            if (std::strcmp(arg, "--help") == 0 || i + 1 >= argc) {
+                return false;
+            }
+            const char* value = argv[++i];
+            if (std::strcmp(arg, "--matches") == 0) options.matches = std::atoi(value);
+            else if (std::strcmp(arg, "--seed") == 0) options.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+            else if (std::strcmp(arg, "--threads") == 0) options.threads = static_cast<unsigned>(std::atoi(value));
+            else if (std::strcmp(arg, "--duration") == 0) options.settings.maxDuration = static_cast<float>(std::atof(value));
+            else if (std::strcmp(arg, "--rate") == 0) options.settings.stepsPerSecond = static_cast<float>(std::atof(value));
+            else if (std::strcmp(arg, "--rings") == 0) options.settings.numRings = std::atoi(value);
+            else if (std::strcmp(arg, "--sections") == 0) options.settings.verticesPerRing = std::atoi(value);
+            else if (std::strcmp(arg, "--iterations") == 0) options.settings.solver.velocityIterations = std::atoi(value);
+            else if (std::strcmp(arg, "--position-iterations") == 0) options.settings.solver.positionIterations = std::atoi(value);
+            else if (std::strcmp(arg, "--record") == 0) options.recordPath = value;
+            else if (std::strcmp(arg, "--replay") == 0) options.replayPath = value;
+            else return false;
+        }
+        return options.matches > 0 && options.settings.stepsPerSecond > 0.0f && options.settings.numRings > 0 &&
+               options.settings.verticesPerRing % 4 == 0 && options.settings.solver.velocityIterations >= 0 &&
+               options.settings.solver.positionIterations >= 0;
+    }
+
+    int runReplay(const Options& options) {
+        ReplayPlayer player;
+        if (!player.load(options.replayPath)) {
+            return 1;
+        }
+
+        JobSystem jobs(options.threads == 0 ? 0 : options.threads - 1);
+        PhysicsWorld world;
+        world.setJobSystem(&jobs);
+        player.createWorld(world);
+
+        float dt = 1.0f / player.getStepsPerSecond();
+        std::vector<double> stepTimes;
+        stepTimes.reserve(player.getStepCount());
+        while (!player.finished()) {
+            player.applyInputs(world);
+            auto start = std::chrono::steady_clock::now();
+            world.update(dt);
+            stepTimes.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            if (!player.endStep(world)) {
+                std::printf("Diverged:         checksum mismatch after step %u\n", player.getDivergedStep());
+                return 2;
+            }
+        }
+
+        double total = 0.0;
+        for (double t : stepTimes) total += t;
+        std::sort(stepTimes.begin(), stepTimes.end());
+        auto percentile = [&](double p) {
+            return stepTimes.empty() ? 0.0 : stepTimes[static_cast<size_t>(p * static_cast<double>(stepTimes.size() - 1))];
+        };
+        std::printf("Replay:           %u steps, %zu bodies, %.0f Hz, %u threads\n", player.getStepCount(),
+                    world.bodies.size(), player.getStepsPerSecond(), jobs.getThreadCount());
+        std::printf("Checksums:        %u verified, no divergence\n", player.getChecksumsVerified());
+        std::printf("Step time:        %.2f us mean, %.2f us p50, %.2f us p99, %.2f us max\n",
+                    stepTimes.empty() ? 0.0 : 1e6 * total / static_cast<double>(stepTimes.size()),
+                    1e6 * percentile(0.5), 1e6 * percentile(0.99), 1e6 * percentile(1.0));
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+    if (options.replayPath) {
+        return runReplay(options);
+    }
+
+    BeybladeConfig configs[2];
+    configs[0].name = "Attack";
+    configs[0].mass = 1.1f;
+    configs[0].spinDecay = 25.0f;
+    configs[1].name = "Stamina";
+    configs[1].mass = 0.9f;
+    configs[1].spinDecay = 15.0f;
+
+    JobSystem jobs(options.threads == 0 ? 0 : options.threads - 1);
+    std::vector<MatchResult> results(options.matches);
+    ReplayRecorder recorder;
+
+    // One match per job, each world single threaded. Every thread keeps its own Match and resets it between
+    // matches, so bodies come from the same pool slots. The stadium's collision geometry is built once and
+    // shared read-only by every thread's world.
+    std::shared_ptr<const StaticGeometry> stadiumGeometry = createStadiumGeometry(options.settings);
+    std::vector<std::unique_ptr<Match>> threadMatches(jobs.getThreadCount());
+    auto start = std::chrono::steady_clock::now();
+    jobs.parallelFor(results.size(), 1, [&](size_t begin, size_t end, unsigned thread) {
+        for (size_t i = begin; i < end; ++i) {
+            LaunchParameters launches[2];
+            randomLaunches(options.seed + static_cast<unsigned>(i), options.settings, configs, launches);
+            std::unique_ptr<Match>& match = threadMatches[thread];
+            if (match) {
+                match->reset(configs, launches);
+            } else {
+                match = std::make_unique<Match>(options.settings, configs, launches, stadiumGeometry);
+            }
+            if (i == 0 && options.recordPath) {
+                match->setRecorder(&recorder);
+            }
+            results[i] = match->run();
+        }
+    });
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long long totalSteps = 0;
+    double setupSeconds = 0.0;
+    double stepSeconds = 0.0;
+    double maxStepSeconds = 0.0;
+    double solverSeconds = 0.0;
+    double residualSum = 0.0;
+    long long solvedSteps = 0;
+    float maxResidual = 0.0f;
+    double simulatedSeconds = 0.0;
+    int wins[2] = {0, 0};
+    int ringOuts = 0, spinOuts = 0, draws = 0;
+    for (const MatchResult& result : results) {
+        totalSteps += result.steps;
+        setupSeconds += result.setupSeconds;
+        stepSeconds += result.stepSeconds;
+        maxStepSeconds = std::max(maxStepSeconds, result.maxStepSeconds);
+        solverSeconds += result.solverSeconds;
+        residualSum += result.residualSum;
+        solvedSteps += result.solvedSteps;
+        maxResidual = std::max(maxResidual, result.maxResidual);
+        simulatedSeconds += result.simulatedSeconds;
+        if (result.winner >= 0) wins[result.winner]++;
+        switch (result.outcome) {
+            case MatchOutcome::RingOut: ringOuts++; break;
+            case MatchOutcome::SpinOut: spinOuts++; break;
+            case MatchOutcome::Draw: draws++; break;
+        }
+    }
+
+    if (options.settings.analyticStadium) {
+        std::printf("Matches:          %d on %u threads, analytic stadium, %.0f Hz\n", options.matches,
+                    jobs.getThreadCount(), options.settings.stepsPerSecond);
+    } else {
+        std::printf("Matches:          %d on %u threads, %d rings x %d sections, %.0f Hz\n", options.matches,
+                    jobs.getThreadCount(), options.settings.numRings, options.settings.verticesPerRing,
+                    options.settings.stepsPerSecond);
+    }
+    std::printf("Stadium:          %zu boxes, %.1f KiB shared by all matches\n", stadiumGeometry->getBoxes().size(),
+                static_cast<double>(stadiumGeometry->memoryBytes()) / 1024.0);
+    std::printf("Wall time:        %.3f s\n", wallSeconds);
+    std::printf("Throughput:       %.1f matches/s, %.0f steps/s\n", options.matches / wallSeconds,
+                static_cast<double>(totalSteps) / wallSeconds);
+    std::printf("Simulated:        %.1f s total, %.2f s per match, %.0fx real time\n", simulatedSeconds,
+                simulatedSeconds / options.matches, simulatedSeconds / wallSeconds);
+    std::printf("Setup:            %.3f ms per match\n", 1e3 * setupSeconds / options.matches);
+    std::printf("Step time:        %.2f us mean, %.2f us max\n",
+                totalSteps > 0 ? 1e6 * stepSeconds / static_cast<double>(totalSteps) : 0.0, 1e6 * maxStepSeconds);
+    std::printf("Solver:           %d + %d iterations, %.2f us mean per step\n",
+                options.settings.solver.velocityIterations, options.settings.solver.positionIterations,
+                totalSteps > 0 ? 1e6 * solverSeconds / static_cast<double>(totalSteps) : 0.0);
+    std::printf("Residual:         %.3g mean, %.3g max over %lld steps with contacts\n",
+                solvedSteps > 0 ? residualSum / static_cast<double>(solvedSteps) : 0.0, maxResidual, solvedSteps);
+    std::printf("Wins:             %s %d, %s %d, draws %d\n", configs[0].name.c_str(), wins[0],
+                configs[1].name.c_str(), wins[1], draws);
+    std::printf("Outcomes:         %d ring-out, %d spin-out, %d draw\n", ringOuts, spinOuts, draws);
+
+    if (options.recordPath) {
+        if (!recorder.save(options.recordPath)) {
+            return 1;
+        }
+        std::printf("Recorded:         match 0, %u steps, %zu bytes to %s\n", recorder.getStepCount(),
+                    recorder.getSizeBytes(), options.recordPath);
+    }
+    return 0;
+}
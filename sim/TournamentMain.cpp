@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "JobSystem.h"
+#include "Match.h"
+
+// Headless round robin for balancing parts. Reads a roster of tops, plays every pairing K times with seeded
+// random launches spread over every core, and prints the win-rate matrix with throughput.
+//
+// Usage: BattleBeyzTournament --roster FILE [--rounds K] [--seed S] [--threads T] [--duration SECONDS]
+//                             [--rate HZ] [--json FILE]
+//
+// Each pair of rounds plays the same launches with the sides swapped, so neither top gets the better start.
+// Results depend only on the roster, rounds and seed, never on the thread count.
+// --json writes the roster, the win and draw matrices and the timing for comparing balance passes.
+
+namespace {
+    struct Options {
+        const char* rosterPath = nullptr;
+        const char* jsonPath = nullptr;
+        int rounds = 100;
+        unsigned seed = 1;
+        unsigned threads = 0;  // 0 uses every hardware thread
+        MatchSettings settings;
+    };
+
+    // What a match means for the tournament, small enough to keep for every match
+    struct MatchRecord {
+        int winner = -1;  // Roster index, -1 for a draw
+        MatchOutcome outcome = MatchOutcome::Draw;
+        int steps = 0;
+        float simulatedSeconds = 0.0f;
+        double stepSeconds = 0.0;
+    };
+
+    void printUsage() {
+        std::printf("Usage: BattleBeyzTournament --roster FILE [--rounds K] [--seed S] [--threads T] "
+                    "[--duration SECONDS] [--rate HZ] [--json FILE]\n");
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            if (std::strcmp(arg, "--help") == 0 || i + 1 >= argc) {
+                return false;
+            }
+            const char* value = argv[++i];
+            if (std::strcmp(arg, "--roster") == 0) options.rosterPath = value;
+            else if (std::strcmp(arg, "--rounds") == 0) options.rounds = std::atoi(value);
+            else if (std::strcmp(arg, "--seed") == 0) options.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+            else if (std::strcmp(arg, "--threads") == 0) options.threads = static_cast<unsigned>(std::atoi(value));
+            else if (std::strcmp(arg, "--duration") == 0) options.settings.maxDuration = static_cast<float>(std::atof(value));
+            else if (std::strcmp(arg, "--rate") == 0) options.settings.stepsPerSecond = static_cast<float>(std::atof(value));
+            else if (std::strcmp(arg, "--json") == 0) options.jsonPath = value;
+            else return false;
+        }
+        return options.rosterPath && options.rounds > 0 && options.settings.stepsPerSecond > 0.0f;
+    }
+
+    // One top per line: a name, then key=value overrides of the BeybladeConfig defaults. # starts a comment.
+    bool loadRoster(const char* path, std::vector<BeybladeConfig>& roster) {
+        std::ifstream file(path);
+        if (!file) {
+            std::fprintf(stderr, "Could not open roster %s\n", path);
+            return false;
+        }
+
+        std::string line;
+        for (int lineNumber = 1; std::getline(file, line); ++lineNumber) {
+            line = line.substr(0, line.find('#'));
+            std::istringstream tokens(line);
+            BeybladeConfig config;
+            if (!(tokens >> config.name)) continue;
+
+            std::string token;
+            while (tokens >> token) {
+                size_t equals = token.find('=');
+                std::string key = token.substr(0, equals);
+                float value = equals == std::string::npos ? 0.0f : std::strtof(token.c_str() + equals + 1, nullptr);
+                if (equals == std::string::npos) key.clear();
+
+                if (key == "mass") config.mass = value;
+                else if (key == "radius") config.radius = value;
+                else if (key == "height") config.height = value;
+                else if (key == "spinDecay") config.spinDecay = value;
+                else if (key == "friction") config.friction = value;
+                else {
+                    std::fprintf(stderr, "%s:%d: unknown setting \"%s\"\n", path, lineNumber, token.c_str());
+                    return false;
+                }
+            }
+            if (config.mass <= 0.0f || config.radius <= 0.0f || config.height <= 0.0f) {
+                std::fprintf(stderr, "%s:%d: mass, radius and height must be positive\n", path, lineNumber);
+                return false;
+            }
+            for (const BeybladeConfig& other : roster) {
+                if (other.name == config.name) {
+                    std::fprintf(stderr, "%s:%d: %s is already in the roster\n", path, lineNumber, config.name.c_str());
+                    return false;
+                }
+            }
+            roster.push_back(config);
+        }
+
+        if (roster.size() < 2) {
+            std::fprintf(stderr, "Roster %s needs at least two tops\n", path);
+            return false;
+        }
+        return true;
+    }
+
+    std::string jsonString(const std::string& text) {
+        std::string quoted = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') quoted += '\\';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    bool writeJson(const char* path, const Options& options, unsigned threads, const std::vector<BeybladeConfig>& roster,
+                   const std::vector<std::vector<int>>& wins, const std::vector<std::vector<int>>& draws,
+                   double wallSeconds, size_t matches, long long steps, double stepSeconds, double simulatedSeconds) {
+        FILE* file = std::fopen(path, "w");
+        if (!file) {
+            std::fprintf(stderr, "Could not write %s\n", path);
+            return false;
+        }
+
+        size_t count = roster.size();
+        std::fprintf(file, "{\n  \"format\": 1,\n  \"rounds\": %d,\n  \"seed\": %u,\n  \"threads\": %u,\n",
+                     options.rounds, options.seed, threads);
+        std::fprintf(file, "  \"roster\": [\n");
+        for (size_t i = 0; i < count; ++i) {
+            const BeybladeConfig& c = roster[i];
+            std::fprintf(file, "    {\"name\": %s, \"mass\": %g, \"radius\": %g, \"height\": %g, \"spinDecay\": %g, "
+                               "\"friction\": %g}%s\n", jsonString(c.name).c_str(), c.mass, c.radius, c.height,
+                         c.spinDecay, c.friction, i + 1 < count ? "," : "");
+        }
+
+        // Row i, column j: share of the i against j matches that i won (or that were drawn); null on the diagonal
+        auto writeMatrix = [&](const char* name, const std::vector<std::vector<int>>& counts) {
+            std::fprintf(file, "  ],\n  \"%s\": [\n", name);
+            for (size_t i = 0; i < count; ++i) {
+                std::fprintf(file, "    [");
+                for (size_t j = 0; j < count; ++j) {
+                    if (i == j) std::fprintf(file, "null");
+                    else std::fprintf(file, "%.4f", static_cast<double>(counts[i][j]) / options.rounds);
+                    std::fprintf(file, "%s", j + 1 < count ? ", " : "");
+                }
+                std::fprintf(file, "]%s\n", i + 1 < count ? "," : "");
+            }
+        };
+        writeMatrix("win_rate", wins);
+        writeMatrix("draw_rate", draws);
+
+        std::fprintf(file, "  ],\n  \"timing\": {\"wall_seconds\": %.3f, \"matches\": %zu, \"matches_per_minute\": %.1f, "
+                           "\"steps_per_second\": %.0f, \"mean_step_us\": %.3f, \"simulated_seconds\": %.1f}\n}\n",
+                     wallSeconds, matches, 60.0 * static_cast<double>(matches) / wallSeconds,
+                     static_cast<double>(steps) / wallSeconds,
+                     steps > 0 ? 1e6 * stepSeconds / static_cast<double>(steps) : 0.0, simulatedSeconds);
+        std::fclose(file);
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+    std::vector<BeybladeConfig> roster;
+    if (!loadRoster(options.rosterPath, roster)) {
+        return 1;
+    }
+
+    struct Pairing {
+        int a;
+        int b;
+    };
+    std::vector<Pairing> pairings;
+    for (int a = 0; a < static_cast<int>(roster.size()); ++a) {
+        for (int b = a + 1; b < static_cast<int>(roster.size()); ++b) {
+            pairings.push_back({a, b});
+        }
+    }
+
+    auto rounds = static_cast<size_t>(options.rounds);
+    std::vector<MatchRecord> records(pairings.size() * rounds);
+    JobSystem jobs(options.threads == 0 ? 0 : options.threads - 1);
+
+    // One match per job. Every thread keeps its own Match, and with it its own PhysicsWorld, and resets it
+    // between matches. All of them share one read-only copy of the stadium's collision geometry.
+    std::shared_ptr<const StaticGeometry> stadiumGeometry = createStadiumGeometry(options.settings);
+    std::vector<std::unique_ptr<Match>> threadMatches(jobs.getThreadCount());
+    auto start = std::chrono::steady_clock::now();
+    jobs.parallelFor(records.size(), 1, [&](size_t begin, size_t end, unsigned thread) {
+        for (size_t i = begin; i < end; ++i) {
+            const Pairing& pairing = pairings[i / rounds];
+            size_t round = i % rounds;
+            bool swapped = round % 2 == 1;
+            int sides[2] = {swapped ? pairing.b : pairing.a, swapped ? pairing.a : pairing.b};
+            BeybladeConfig configs[2] = {roster[sides[0]], roster[sides[1]]};
+
+            // Rounds 2n and 2n + 1 share a seed, so the same launches are played from both sides
+            LaunchParameters launches[2];
+            auto seed = static_cast<unsigned>(options.seed + (i / rounds) * rounds + round / 2);
+            randomLaunches(seed, options.settings, configs, launches);
+            if (swapped) std::swap(launches[0], launches[1]);
+
+            std::unique_ptr<Match>& match = threadMatches[thread];
+            if (match) {
+                match->reset(configs, launches);
+            } else {
+                match = std::make_unique<Match>(options.settings, configs, launches, stadiumGeometry);
+            }
+            MatchResult result = match->run();
+
+            MatchRecord& record = records[i];
+            record.winner = result.winner >= 0 ? sides[result.winner] : -1;
+            record.outcome = result.outcome;
+            record.steps = result.steps;
+            record.simulatedSeconds = result.simulatedSeconds;
+            record.stepSeconds = result.stepSeconds;
+        }
+    });
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t count = roster.size();
+    std::vector<std::vector<int>> wins(count, std::vector<int>(count, 0));
+    std::vector<std::vector<int>> draws(count, std::vector<int>(count, 0));
+    std::vector<int> totalWins(count, 0);
+    long long totalSteps = 0;
+    double stepSeconds = 0.0;
+    double simulatedSeconds = 0.0;
+    int ringOuts = 0, spinOuts = 0, drawCount = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        const Pairing& pairing = pairings[i / rounds];
+        const MatchRecord& record = records[i];
+        if (record.winner >= 0) {
+            int loser = record.winner == pairing.a ? pairing.b : pairing.a;
+            wins[record.winner][loser]++;
+            totalWins[record.winner]++;
+        } else {
+            draws[pairing.a][pairing.b]++;
+            draws[pairing.b][pairing.a]++;
+        }
+        switch (record.outcome) {
+            case MatchOutcome::RingOut: ringOuts++; break;
+            case MatchOutcome::SpinOut: spinOuts++; break;
+            case MatchOutcome::Draw: drawCount++; break;
+        }
+        totalSteps += record.steps;
+        stepSeconds += record.stepSeconds;
+        simulatedSeconds += record.simulatedSeconds;
+    }
+
+    std::printf("Tournament:       %zu tops, %zu pairings x %d rounds = %zu matches on %u threads\n", count,
+                pairings.size(), options.rounds, records.size(), jobs.getThreadCount());
+    std::printf("Wall time:        %.3f s\n", wallSeconds);
+    std::printf("Throughput:       %.0f matches/min, %.0f steps/s\n",
+                60.0 * static_cast<double>(records.size()) / wallSeconds, static_cast<double>(totalSteps) / wallSeconds);
+    std::printf("Simulated:        %.1f s total, %.2f s per match\n", simulatedSeconds,
+                simulatedSeconds / static_cast<double>(records.size()));
+    std::printf("Step time:        %.2f us mean\n", totalSteps > 0 ? 1e6 * stepSeconds / static_cast<double>(totalSteps) : 0.0);
+    std::printf("Outcomes:         %d ring-out, %d spin-out, %d draw\n", ringOuts, spinOuts, drawCount);
+
+    // Row beats column, as a percentage of their matches
+    std::printf("\n%-12s", "Win %");
+    for (const BeybladeConfig& config : roster) {
+        std::printf(" %9.9s", config.name.c_str());
+    }
+    std::printf(" %9s\n", "Overall");
+    for (size_t i = 0; i < count; ++i) {
+        std::printf("%-12.12s", roster[i].name.c_str());
+        for (size_t j = 0; j < count; ++j) {
+            if (i == j) std::printf(" %9s", "-");
+            else std::printf(" %8.1f%%", 100.0 * wins[i][j] / options.rounds);
+        }
+        std::printf(" %8.1f%%\n", 100.0 * totalWins[i] / (static_cast<double>(options.rounds) * static_cast<double>(count - 1)));
+    }
+
+    if (options.jsonPath &&
+        !writeJson(options.jsonPath, options, jobs.getThreadCount(), roster, wins, draws, wallSeconds, records.size(),
+                   totalSteps, stepSeconds, simulatedSeconds)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <numeric>
+#include <cfloat>
+#include "BVH.h"
+
+namespace {
+    constexpr int kBinCount = 12;
+    constexpr uint32_t kMinLeafSize = 2;   // Never split below this many primitives
+    constexpr uint32_t kMaxLeafSize = 8;   // Always split above this many, even when SAH prefers a leaf
+    constexpr int kMaxDepth = 48;          // Keeps BVH::query's fixed traversal stack safe
+
+    float halfSurfaceArea(const glm::vec3& min, const glm::vec3& max) {
+        glm::vec3 e = glm::max(max - min, glm::vec3(0.0f));
+        return e.x * e.y + e.y * e.z + e.z * e.x;
+    }
+}
+
+void BVH::build(const std::vector<BoundingBox>& boxes) {
+    nodes.clear();
+    primitives.clear();
+    primitiveBounds.clear();
+    if (boxes.empty()) return;
+
+    auto count = static_cast<uint32_t>(boxes.size());
+    std::vector<Bounds> bounds(count);
+    std::vector<glm::vec3> centroids(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        bounds[i] = {boxes[i].min, boxes[i].max};
+        centroids[i] = (boxes[i].min + boxes[i].max) * 0.5f;
+    }
+
+    primitives.resize(count);
+    std::iota(primitives.begin(), primitives.end(), 0u);
+    nodes.reserve(2 * count);
+
+    buildRecursive(bounds, centroids, 0, count, 0);
+
+    primitiveBounds.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        primitiveBounds[i] = bounds[primitives[i]];
+    }
+}
+
+void BVH::refit(const std::vector<BoundingBox>& boxes) {
+    for (size_t i = 0; i < primitives.size(); ++i) {
+        primitiveBounds[i] = {boxes[primitives[i]].min, boxes[primitives[i]].max};
+    }
+
+    // Children always come after their parent, so a reverse pass sees both children before the parent
+    for (size_t i = nodes.size(); i-- > 0;) {
+        BVHNode& node = nodes[i];
+        glm::vec3 nodeMin(FLT_MAX), nodeMax(-FLT_MAX);
+        if (node.count > 0) {
+            for (uint32_t j = node.rightOrFirst; j < node.rightOrFirst + node.count; ++j) {
+                nodeMin = glm::min(nodeMin, primitiveBounds[j].min);
+                nodeMax = glm::max(nodeMax, primitiveBounds[j].max);
+            }
+        } else {
+            const BVHNode& left = nodes[i + 1];
+            const BVHNode& right = nodes[node.rightOrFirst];
+            nodeMin = glm::min(left.min, right.min);
+            nodeMax = glm::max(left.max, right.max);
+        }
+        node.min = nodeMin;
+        node.max = nodeMax;
+    }
+}
+
+uint32_t BVH::buildRecursive(const std::vector<Bounds>& bounds, const std::vector<glm::vec3>& centroids,
+                             uint32_t begin, uint32_t end, int depth) {
+    auto nodeIndex = static_cast<uint32_t>(nodes.size());
+    nodes.push_back({});
+
+    glm::vec3 nodeMin(FLT_MAX), nodeMax(-FLT_MAX);
+    glm::vec3 centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+    for (uint32_t i = begin; i < end; ++i) {
+        const Bounds& b = bounds[primitives[i]];
+        nodeMin = glm::min(nodeMin, b.min);
+        nodeMax = glm::max(nodeMax, b.max);
+        centroidMin = glm::min(centroidMin, centroids[primitives[i]]);
+        centroidMax = glm::max(centroidMax, centroids[primitives[i]]);
+    }
+    nodes[nodeIndex].min = nodeMin;
+    nodes[nodeIndex].max = nodeMax;
+
+    uint32_t count = end - begin;
+    auto makeLeaf = [&]() {
+        nodes[nodeIndex].rightOrFirst = begin;
+        nodes[nodeIndex].count = count;
+        return nodeIndex;
+    };
+    if (count <= kMinLeafSize || depth >= kMaxDepth) return makeLeaf();
+
+    // Binned SAH: bucket centroids along each axis and pick the cheapest plane between buckets
+    float bestCost = FLT_MAX;
+    int bestAxis = -1;
+    int bestSplit = 0;
+    glm::vec3 extent = centroidMax - centroidMin;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (extent[axis] <= 0.0f) continue;
+
+        uint32_t binCounts[kBinCount] = {};
+        glm::vec3 binMin[kBinCount], binMax[kBinCount];
+        std::fill(binMin, binMin + kBinCount, glm::vec3(FLT_MAX));
+        std::fill(binMax, binMax + kBinCount, glm::vec3(-FLT_MAX));
+
+        float scale = kBinCount / extent[axis];
+        for (uint32_t i = begin; i < end; ++i) {
+            uint32_t prim = primitives[i];
+            int bin = std::min(kBinCount - 1, static_cast<int>((centroids[prim][axis] - centroidMin[axis]) * scale));
+            binCounts[bin]++;
+            binMin[bin] = glm::min(binMin[bin], bounds[prim].min);
+            binMax[bin] = glm::max(binMax[bin], bounds[prim].max);
+        }
+
+        // Sweep from the right to get the cost of every right-hand side, then from the left to combine
+        float rightArea[kBinCount];
+        uint32_t rightCount[kBinCount];
+        glm::vec3 accMin(FLT_MAX), accMax(-FLT_MAX);
+        uint32_t acc = 0;
+        for (int bin = kBinCount - 1; bin > 0; --bin) {
+            accMin = glm::min(accMin, binMin[bin]);
+            accMax = glm::max(accMax, binMax[bin]);
+            acc += binCounts[bin];
+            rightArea[bin] = acc > 0 ? halfSurfaceArea(accMin, accMax) : 0.0f;
+            rightCount[bin] = acc;
+        }
+
+        accMin = glm::vec3(FLT_MAX);
+        accMax = glm::vec3(-FLT_MAX);
+        acc = 0;
+        for (int split = 1; split < kBinCount; ++split) {
+            accMin = glm::min(accMin, binMin[split - 1]);
+            accMax = glm::max(accMax, binMax[split - 1]);
+            acc += binCounts[split - 1];
+            if (acc == 0 || rightCount[split] == 0) continue;
+
+            float cost = halfSurfaceArea(accMin, accMax) * static_cast<float>(acc) +
+                         rightArea[split] * static_cast<float>(rightCount[split]);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = split;
+            }
+        }
+    }
+
+    float leafCost = halfSurfaceArea(nodeMin, nodeMax) * static_cast<float>(count);
+    if (bestAxis < 0 || (bestCost >= leafCost && count <= kMaxLeafSize)) return makeLeaf();
+
+    float scale = kBinCount / extent[bestAxis];
+    float axisMin = centroidMin[bestAxis];
+    auto middle = std::partition(primitives.begin() + begin, primitives.begin() + end, [&](uint32_t prim) {
+        int bin = std::min(kBinCount - 1, static_cast<int>((centroids[prim][bestAxis] - axisMin) * scale));
+        return bin < bestSplit;
+    });
+    auto mid = static_cast<uint32_t>(middle - primitives.begin());
+    if (mid == begin || mid == end) return makeLeaf();
+
+    buildRecursive(bounds, centroids, begin, mid, depth + 1);
+    uint32_t right = buildRecursive(bounds, centroids, mid, end, depth + 1);
+    nodes[nodeIndex].rightOrFirst = right;
+    nodes[nodeIndex].count = 0;
+    return nodeIndex;
+}
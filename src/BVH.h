@@ -0,0 +1,238 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include "BoundingBox.h"
+
+// Flattened bounding volume hierarchy over a fixed set of boxes, built with a binned surface area heuristic.
+// Nodes are stored in depth-first order: an interior node's left child is the next node, and its right child
+// is at rightOrFirst. Leaves point at a run of primitive indices instead.
+struct BVHNode {
+    glm::vec3 min;
+    uint32_t rightOrFirst;  // Interior: right child index. Leaf: first entry in BVH::primitives
+    glm::vec3 max;
+    uint32_t count;         // Number of primitives, 0 for interior nodes
+};
+
+class BVH {
+public:
+    void build(const std::vector<BoundingBox>& boxes);
+    // Moves the node bounds to new boxes without changing the tree. boxes must be the same size as at build time.
+    // Allocates nothing, but the tree gets looser the further the boxes move from where they were built.
+    void refit(const std::vector<BoundingBox>& boxes);
+
+    // Calls visit(index) for every box (index into the vector given to build) overlapping [min, max]
+    template<typename Visitor>
+    void query(const glm::vec3& min, const glm::vec3& max, Visitor&& visit) const;
+    // Like query, but stops at the first box for which accept(index) returns true
+    template<typename Predicate>
+    bool anyOverlap(const glm::vec3& min, const glm::vec3& max, Predicate&& accept) const;
+    // Calls visit(index) for the boxes in every leaf the ray origin + t * direction enters with t in
+    // [0, maxDistance], nearer subtrees first. The boxes themselves are not tested, visit does its own exact
+    // test and returns the new maxDistance, so subtrees beyond the closest hit so far are skipped.
+    template<typename Visitor>
+    void queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Visitor&& visit) const;
+
+    [[nodiscard]] bool empty() const { return nodes.empty(); }
+    [[nodiscard]] size_t nodeCount() const { return nodes.size(); }
+    [[nodiscard]] size_t memoryBytes() const {
+        return nodes.capacity() * sizeof(BVHNode) + primitives.capacity() * sizeof(uint32_t) +
+               primitiveBounds.capacity() * sizeof(Bounds);
+    }
+
+private:
+    struct Bounds {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    std::vector<BVHNode> nodes;
+    std::vector<uint32_t> primitives;   // Original box indices, grouped by leaf
+    std::vector<Bounds> primitiveBounds; // Copied in leaf order so leaf scans stay contiguous
+
+    uint32_t buildRecursive(const std::vector<Bounds>& bounds, const std::vector<glm::vec3>& centroids,
+                            uint32_t begin, uint32_t end, int depth);
+};
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BATTLEBEYZ_BVH_SSE 1
+#include <emmintrin.h>
+#endif
+
+// A ray prepared for slab tests. The inverse direction is taken once, with zero components replaced by a huge
+// value so axis-parallel rays never produce 0 * inf. On x86 a node's three slabs are tested in one SSE operation.
+struct BVHRay {
+    glm::vec3 origin;
+    glm::vec3 inverseDirection;
+
+    BVHRay(const glm::vec3& origin, const glm::vec3& direction);
+
+    // Where the ray enters [min, max], clamped to 0, if it does so before maxDistance
+    bool enters(const glm::vec3& min, const glm::vec3& max, float maxDistance, float& entry) const {
+        glm::vec3 t0 = (min - origin) * inverseDirection;
+        glm::vec3 t1 = (max - origin) * inverseDirection;
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+        entry = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+        return entry <= exit;
+    }
+    bool enters(const BVHNode& node, float maxDistance, float& entry) const;
+
+#ifdef BATTLEBEYZ_BVH_SSE
+private:
+    __m128 originLanes;
+    __m128 inverseLanes;  // w lane is 0, so the index word loaded after min and max drops out
+#endif
+};
+
+inline BVHRay::BVHRay(const glm::vec3& origin, const glm::vec3& direction) : origin(origin) {
+    for (int axis = 0; axis < 3; ++axis) {
+        float d = direction[axis];
+        inverseDirection[axis] = std::abs(d) > 1e-20f ? 1.0f / d : (d < 0.0f ? -1e30f : 1e30f);
+    }
+#ifdef BATTLEBEYZ_BVH_SSE
+    originLanes = _mm_setr_ps(origin.x, origin.y, origin.z, 0.0f);
+    inverseLanes = _mm_setr_ps(inverseDirection.x, inverseDirection.y, inverseDirection.z, 0.0f);
+#endif
+}
+
+inline bool BVHRay::enters(const BVHNode& node, float maxDistance, float& entry) const {
+#ifdef BATTLEBEYZ_BVH_SSE
+    // min and max are each followed by a 32-bit word, so one unaligned load picks up x, y, z and that word
+    __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&node.min.x), originLanes), inverseLanes);
+    __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&node.max.x), originLanes), inverseLanes);
+    // The w lane is 0 in both, which clamps the entry to 0; the exit gets maxDistance there instead
+    __m128 tNear = _mm_min_ps(t0, t1);
+    __m128 tFar = _mm_max_ps(t0, t1);
+    const __m128 xyzMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    tFar = _mm_or_ps(_mm_and_ps(xyzMask, tFar), _mm_andnot_ps(xyzMask, _mm_set1_ps(maxDistance)));
+
+    tNear = _mm_max_ps(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(1, 0, 3, 2)));
+    tNear = _mm_max_ps(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(2, 3, 0, 1)));
+    tFar = _mm_min_ps(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(1, 0, 3, 2)));
+    tFar = _mm_min_ps(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(2, 3, 0, 1)));
+    entry = _mm_cvtss_f32(tNear);
+    return entry <= _mm_cvtss_f32(tFar);
+#else
+    return enters(node.min, node.max, maxDistance, entry);
+#endif
+}
+
+template<typename Visitor>
+void BVH::query(const glm::vec3& min, const glm::vec3& max, Visitor&& visit) const {
+    if (nodes.empty()) return;
+
+    uint32_t stack[64];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const BVHNode& node = nodes[stack[--top]];
+        if (node.min.x > max.x || node.max.x < min.x ||
+            node.min.y > max.y || node.max.y < min.y ||
+            node.min.z > max.z || node.max.z < min.z) {
+            continue;
+        }
+
+        if (node.count > 0) {
+            for (uint32_t i = node.rightOrFirst; i < node.rightOrFirst + node.count; ++i) {
+                const Bounds& b = primitiveBounds[i];
+                if (b.min.x <= max.x && b.max.x >= min.x &&
+                    b.min.y <= max.y && b.max.y >= min.y &&
+                    b.min.z <= max.z && b.max.z >= min.z) {
+                    visit(primitives[i]);
+                }
+            }
+        } else {
+            stack[top++] = node.rightOrFirst;
+            stack[top++] = static_cast<uint32_t>(&node - nodes.data()) + 1;
+        }
+    }
+}
+
+template<typename Predicate>
+bool BVH::anyOverlap(const glm::vec3& min, const glm::vec3& max, Predicate&& accept) const {
+    if (nodes.empty()) return false;
+
+    uint32_t stack[64];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const BVHNode& node = nodes[stack[--top]];
+        if (node.min.x > max.x || node.max.x < min.x ||
+            node.min.y > max.y || node.max.y < min.y ||
+            node.min.z > max.z || node.max.z < min.z) {
+            continue;
+        }
+
+        if (node.count > 0) {
+            for (uint32_t i = node.rightOrFirst; i < node.rightOrFirst + node.count; ++i) {
+                const Bounds& b = primitiveBounds[i];
+                if (b.min.x <= max.x && b.max.x >= min.x &&
+                    b.min.y <= max.y && b.max.y >= min.y &&
+                    b.min.z <= max.z && b.max.z >= min.z && accept(primitives[i])) {
+                    return true;
+                }
+            }
+        } else {
+            stack[top++] = node.rightOrFirst;
+            stack[top++] = static_cast<uint32_t>(&node - nodes.data()) + 1;
+        }
+    }
+    return false;
+}
+
+template<typename Visitor>
+void BVH::queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Visitor&& visit) const {
+    if (nodes.empty()) return;
+
+    BVHRay ray(origin, direction);
+    struct Pending {
+        uint32_t node;
+        float entry;
+    };
+    Pending stack[64];
+    int top = 0;
+    float entry;
+    if (!ray.enters(nodes[0], maxDistance, entry)) return;
+    stack[top++] = {0, entry};
+
+    while (top > 0) {
+        Pending pending = stack[--top];
+        // A closer hit may have been found since this node was pushed
+        if (pending.entry > maxDistance) continue;
+
+        const BVHNode& node = nodes[pending.node];
+        if (node.count > 0) {
+            for (uint32_t i = node.rightOrFirst; i < node.rightOrFirst + node.count; ++i) {
+                maxDistance = visit(primitives[i]);
+            }
+            continue;
+        }
+
+        // Test both children now and push the nearer one last, so it is searched first
+        uint32_t left = pending.node + 1;
+        uint32_t right = node.rightOrFirst;
+        float leftEntry, rightEntry;
+        bool hitLeft = ray.enters(nodes[left], maxDistance, leftEntry);
+        bool hitRight = ray.enters(nodes[right], maxDistance, rightEntry);
+        if (hitLeft && hitRight) {
+            if (leftEntry <= rightEntry) {
+                stack[top++] = {right, rightEntry};
+                stack[top++] = {left, leftEntry};
+            } else {
+                stack[top++] = {left, leftEntry};
+                stack[top++] = {right, rightEntry};
+            }
+        } else if (hitLeft) {
+            stack[top++] = {left, leftEntry};
+        } else if (hitRight) {
+            stack[top++] = {right, rightEntry};
+        }
+    }
+}
@@ -1,6 +1,5 @@
 #include "Beyblade.h"
-#define TINYOBJLOADER_IMPLEMENTATION
-#include "tiny_obj_loader.h"
+#include "ObjLoader.h"
 
 void Beyblade::printDebugInfo() {
     std::ostringstream buffer;
@@ -36,6 +35,7 @@ void Beyblade::printDebugInfo() {
 Beyblade::Beyblade(std::string modelPath, unsigned int vao, unsigned int vbo, unsigned int ebo,
                    const glm::vec3& pos, RigidBody* rigidBody)
         : modelPath(std::move(modelPath)), GameObject(vao, vbo, ebo, pos, glm::vec3(1.0)), rigidBody(rigidBody) {
+    name = this->modelPath.substr(this->modelPath.find_last_of("/\\") + 1);
     Beyblade::initializeMesh();
 }
 
@@ -45,6 +45,7 @@ Beyblade::~Beyblade() {
 
 void Beyblade::initializeMesh() {
     loadModel(modelPath);
+    pickTree.build(vertices, indices);
 
     if (vertices.size() != normals.size() || vertices.size() != texCoords.size()) {
         std::cerr << "Mesh data is inconsistent" << std::endl;
@@ -89,6 +90,12 @@ void Beyblade::initializeMesh() {
                  indices.size() * sizeof(unsigned int));
 }
 
+glm::mat4 Beyblade::getModelMatrix() const {
+    // Physics owns the body; render where it is interpolated to between fixed steps
+    return glm::translate(glm::mat4(1.0f), rigidBody->renderPosition + renderOffset) *
+           glm::mat4_cast(rigidBody->renderOrientation);
+}
+
 void Beyblade::render(ShaderProgram& shader, const glm::vec3& lightColor, const glm::vec3& lightPos) {
     shader.use();
 
@@ -98,8 +105,7 @@ void Beyblade::render(ShaderProgram& shader, const glm::vec3& lightColor, const
         shader.setInt("texture1", 0);
     }
 
-    glm::mat4 model = glm::translate(glm::mat4(1.0f), rigidBody->position);
-    shader.setUniformMat4("model", model);
+    shader.setUniformMat4("model", getModelMatrix());
 //    shader.setUniformVec3("viewPos", viewPos);
     shader.setUniformVec3("lightColor", lightColor);
     shader.setUniformVec3("lightPos", lightPos);
@@ -118,99 +124,18 @@ void Beyblade::render(ShaderProgram& shader, const glm::vec3& lightColor, const
     }
 }
 
-void Beyblade::update(float deltaTime) {
-    // Update physics
-    rigidBody->update(deltaTime);
-}
-
 void Beyblade::loadModel(const std::string& path) {
-    // Load the OBJ file...
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
-
-    // Extract directory from the path
-    std::string baseDir = path.substr(0, path.find_last_of("/\\"));
-    if (baseDir.empty()) {
-        baseDir = ".";
-    }
-
-    bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str(), baseDir.c_str(), true, true);
-
-    if (!warn.empty()) {
-        std::cout << "WARN::TINYOBJLOADER::" << warn << std::endl;
-    }
-
-    if (!err.empty()) {
-        std::cerr << "ERROR::TINYOBJLOADER::" << err << std::endl;
-    }
-
-    if (!ret) {
-        std::cerr << "ERROR::TINYOBJLOADER::Failed to load/parse .obj.\n";
+    ObjMesh mesh;
+    if (!loadObjMesh(path, mesh)) {
         return;
     }
 
-    // Clear previous data
-    vertices.clear();
-    normals.clear();
-    texCoords.clear();
-    colors.clear();
-    indices.clear();
-    materialColors.clear();
-
-    std::unordered_map<unsigned int, glm::vec3> vertexMap;
-    std::unordered_map<unsigned int, glm::vec3> normalMap;
-    std::unordered_map<unsigned int, glm::vec2> texCoordMap;
-
-    // Extract vertices, normals, and texture coordinates...
-    for (size_t v = 0; v < attrib.vertices.size() / 3; ++v) {
-        vertexMap[v] = glm::vec3(attrib.vertices[3 * v + 0], attrib.vertices[3 * v + 1], attrib.vertices[3 * v + 2]);
-    }
-
-    for (size_t n = 0; n < attrib.normals.size() / 3; ++n) {
-        normalMap[n] = glm::vec3(attrib.normals[3 * n + 0], attrib.normals[3 * n + 1], attrib.normals[3 * n + 2]);
-    }
-
-    for (size_t t = 0; t < attrib.texcoords.size() / 2; ++t) {
-        texCoordMap[t] = glm::vec2(attrib.texcoords[2 * t + 0], attrib.texcoords[2 * t + 1]);
-    }
-
-    // Handle materials
-    std::unordered_map<int, glm::vec3> materialIndexToDiffuseColor;
-    for (size_t i = 0; i < materials.size(); ++i) {
-        const auto& material = materials[i];
-        glm::vec3 diffuseColor(material.diffuse[0], material.diffuse[1], material.diffuse[2]);
-
-        // Store the material properties in the map
-        materialColors[material.name] = diffuseColor;
-        materialIndexToDiffuseColor[i] = diffuseColor;
-
-        std::cout << "Material name: " << material.name << std::endl;
-        std::cout << "Diffuse: " << diffuseColor.x << ", " << diffuseColor.y << ", " << diffuseColor.z << std::endl;
-    }
-
-    // Extract indices and assemble vertex data
-    for (const auto& shape : shapes) {
-        for (size_t faceIndex = 0; faceIndex < shape.mesh.indices.size() / 3; ++faceIndex) {
-            int materialIndex = shape.mesh.material_ids[faceIndex];
-            glm::vec3 color = materialIndexToDiffuseColor.count(materialIndex) ? materialIndexToDiffuseColor[materialIndex] : glm::vec3(1.0f, 1.0f, 1.0f);
-
-            for (size_t vertexIndex = 0; vertexIndex < 3; ++vertexIndex) {
-                auto index = shape.mesh.indices[3 * faceIndex + vertexIndex];
-                glm::vec3 vertex = vertexMap[index.vertex_index];
-                glm::vec3 normal = normalMap.count(index.normal_index) ? normalMap[index.normal_index] : glm::vec3(0.0f, 0.0f, 0.0f);
-                glm::vec2 texCoord = texCoordMap.count(index.texcoord_index) ? texCoordMap[index.texcoord_index] : glm::vec2(0.0f, 0.0f);
-
-                vertices.push_back(vertex);
-                normals.push_back(normal);
-                texCoords.push_back(texCoord);
-                indices.push_back(indices.size());
-                colors.push_back(color);
-            }
-        }
-    }
+    vertices = std::move(mesh.vertices);
+    normals = std::move(mesh.normals);
+    texCoords = std::move(mesh.texCoords);
+    colors = std::move(mesh.colors);
+    indices = std::move(mesh.indices);
+    materialColors = std::move(mesh.materialColors);
 
     std::cout << "Model loaded successfully with " << vertices.size() << " vertices and " << indices.size() << " indices." << std::endl;
 }
-
@@ -22,15 +22,18 @@ public:
              const glm::vec3& col, RigidBody* rigidBody);
     ~Beyblade();
 
-    void update(float deltaTime);
     void initializeMesh() override;
     void render(ShaderProgram& shader, const glm::vec3& lightColor, const glm::vec3& lightPos) override;
+    [[nodiscard]] glm::mat4 getModelMatrix() const override;
+    // Drawn this far from its body, for bodies simulated around a different origin than the rendered scene
+    void setRenderOffset(const glm::vec3& offset) { renderOffset = offset; }
 
 protected:
 
 private:
     std::unordered_map<std::string, glm::vec3> materialColors;
     RigidBody* rigidBody;
+    glm::vec3 renderOffset{0.0f};
     std::string modelPath;
     Texture* texture{};
 
@@ -1,21 +1,11 @@
-#include <iostream>
+#include <cfloat>
 #include "BoundingBox.h"
 
 BoundingBox::BoundingBox()
-        : min(glm::vec3(FLT_MAX)), max(glm::vec3(-FLT_MAX)), VAO(0), VBO(0), EBO(0) {
-    setupBuffers();
-}
+        : min(glm::vec3(FLT_MAX)), max(glm::vec3(-FLT_MAX)) {}
 
 BoundingBox::BoundingBox(const glm::vec3& min, const glm::vec3& max)
-        : min(min), max(max), VAO(0), VBO(0), EBO(0) {
-    setupBuffers();
-}
-
-BoundingBox::~BoundingBox() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
-}
+        : min(min), max(max) {}
 
 bool BoundingBox::checkCollision(const BoundingBox &other) const {
     return (min.x <= other.max.x && max.x >= other.min.x) &&
@@ -43,28 +33,15 @@ void BoundingBox::update(const glm::vec3& v1, const glm::vec3& v2, const glm::ve
     max = glm::max(v1, glm::max(v2, v3));
 }
 
-void BoundingBox::update(const glm::vec3& position, const glm::quat& orientation) {
-
+BoundingBox BoundingBox::transformed(const glm::vec3& position, const glm::mat3& rotation) const {
     glm::vec3 halfSize = (max - min) * 0.5f;
     glm::vec3 center = min + halfSize;
 
-    glm::vec3 newCenter = position;
-
-    min = newCenter - halfSize;
-    max = newCenter + halfSize;
-
-    // No angular for now
-//    glm::vec3 halfSize = (max - min) * 0.5f;
-//    glm::vec3 localCenter = min + halfSize;
-//
-//    // Transform local center to new center position
-//    glm::vec3 newCenter = position + glm::rotate(orientation, localCenter - position);
-//
-//    // Rotate the half-size vector to account for the bounding box orientation
-//    glm::vec3 rotatedHalfSize = glm::abs(glm::rotate(orientation, halfSize));
-//
-//    min = newCenter - rotatedHalfSize;
-//    max = newCenter + rotatedHalfSize;
+    // Each world half extent is the rotated half size projected back onto the axes
+    glm::mat3 absRotation(glm::abs(rotation[0]), glm::abs(rotation[1]), glm::abs(rotation[2]));
+    glm::vec3 newCenter = position + rotation * center;
+    glm::vec3 rotatedHalfSize = absRotation * halfSize;
+    return {newCenter - rotatedHalfSize, newCenter + rotatedHalfSize};
 }
 
 void BoundingBox::expandToInclude(const BoundingBox& other) {
@@ -76,68 +53,3 @@ void BoundingBox::expandToInclude(const glm::vec3& point) {
     min = glm::min(min, point);
     max = glm::max(max, point);
 }
-
-void BoundingBox::setupBuffers() {
-    float offset = 0.0;
-
-//    float vertices[] = {
-//            // Positions         // Normals         // Texture Coords  // Colors (RGB)
-//            -1.0f, -1.0f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f,      1.0f, 0.0f, 0.0f, // Red
-//            1.0f, -1.0f, -1.0f,  1.0f, 0.0f, 0.0f,  1.0f, 0.0f,      0.0f, 1.0f, 0.0f, // Green
-//            1.0f,  1.0f, -1.0f,  0.0f, 1.0f, 0.0f,  1.0f, 1.0f,      0.0f, 0.0f, 1.0f, // Blue
-//            -1.0f,  1.0f, -1.0f, -1.0f, 0.0f, 0.0f,  0.0f, 1.0f,      1.0f, 1.0f, 0.0f, // Yellow
-//            -1.0f, -1.0f,  1.0f,  0.0f, -1.0f, 0.0f,  0.0f, 0.0f,      1.0f, 0.0f, 1.0f, // Magenta
-//            1.0f, -1.0f,  1.0f,  1.0f, 0.0f, 0.0f,  1.0f, 0.0f,      0.0f, 1.0f, 1.0f, // Cyan
-//            1.0f,  1.0f,  1.0f,  0.0f, 1.0f, 0.0f,  1.0f, 1.0f,      1.0f, 0.5f, 0.0f, // Orange
-//            -1.0f,  1.0f,  1.0f, -1.0f, 0.0f, 0.0f,  0.0f, 1.0f,      0.5f, 0.5f, 0.5f  // Grey
-//    };
-//
-//    unsigned int indices[] = {
-//            0, 1, 2, 2, 3, 0, // Bottom face
-//            4, 5, 6, 6, 7, 4, // Top face
-//            0, 1, 5, 5, 4, 0, // Front face
-//            1, 2, 6, 6, 5, 1, // Right face
-//            2, 3, 7, 7, 6, 2, // Back face
-//            3, 0, 4, 4, 7, 3  // Left face
-//    };
-
-    float vertices[] = {
-            // Positions         // Normals         // Texture Coords  // Colors (RGB)
-            min.x, min.y-offset, min.z,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f,      1.0f, 0.0f, 0.0f, // Red
-            max.x, min.y-offset, min.z,   1.0f, 0.0f, 0.0f,   1.0f, 0.0f,      0.0f, 1.0f, 0.0f, // Green
-            max.x, max.y-offset, min.z,   0.0f, 1.0f, 0.0f,   1.0f, 1.0f,      0.0f, 0.0f, 1.0f, // Blue
-            min.x, max.y-offset, min.z, -1.0f, 0.0f, 0.0f,   0.0f, 1.0f,      1.0f, 1.0f, 0.0f, // Yellow
-            min.x, min.y-offset, max.z,  0.0f, -1.0f, 0.0f,  0.0f, 0.0f,      1.0f, 0.0f, 1.0f, // Magenta
-            max.x, min.y-offset, max.z,   1.0f, 0.0f, 0.0f,   1.0f, 0.0f,      0.0f, 1.0f, 1.0f, // Cyan
-            max.x, max.y-offset, max.z,   0.0f, 1.0f, 0.0f,   1.0f, 1.0f,      1.0f, 0.5f, 0.0f, // Orange
-            min.x, max.y-offset, max.z, -1.0f, 0.0f, 0.0f,   0.0f, 1.0f,      0.5f, 0.5f, 0.5f  // Grey
-    };
-
-    unsigned int indices[] = {
-            0, 1, 2, 2, 3, 0, // Bottom face
-            4, 5, 6, 6, 7, 4, // Top face
-            0, 1, 5, 5, 4, 0, // Front face
-            1, 2, 6, 6, 5, 1, // Right face
-            2, 3, 7, 7, 6, 2, // Back face
-            3, 0, 4, 4, 7, 3  // Left face
-    };
-
-    ::setupBuffers(VAO, VBO, EBO, vertices, sizeof(vertices), indices, sizeof(indices));
-}
-
-void BoundingBox::renderDebug(ShaderProgram &shader) {
-    shader.use();
-    setupBuffers();
-
-    // Set uniform for object color
-    shader.setUniformVec3("objectColor", glm::vec3(1.0f, 1.0f, 1.0f));
-
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr); // 36 is the number of indices for 12 triangles
-    glBindVertexArray(0);
-
-    GLenum err;
-    while ((err = glGetError()) != GL_NO_ERROR) {
-        std::cerr << "OpenGL error: " << err << std::endl;
-    }
-}
\ No newline at end of file
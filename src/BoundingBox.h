@@ -1,29 +1,24 @@
 #pragma once
 
 #define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp> // For glm::rotate
-#include "ShaderProgram.h"
-#include "Buffers.h"
 
+// Plain axis-aligned box used for all collision work. It owns no GPU objects, so physics can run without a
+// GL context; DebugRenderer builds the visuals only when they are drawn.
 class BoundingBox {
 public:
     glm::vec3 min;
     glm::vec3 max;
 
-    GLuint VAO{}, VBO{}, EBO{};
-
     BoundingBox();
     BoundingBox(const glm::vec3& min, const glm::vec3& max);
-    ~BoundingBox();
 
     [[nodiscard]] bool checkCollision(const BoundingBox& other) const;
     [[nodiscard]] bool intersectsSphere(const glm::vec3& center, float radius) const;
     void update(const glm::vec3& v1, const glm::vec3& v2, const glm::vec3& v3);
-    void update(const glm::vec3& position, const glm::quat& orientation);
+    // The axis-aligned box around this one after rotating it about the origin and then moving it by position
+    [[nodiscard]] BoundingBox transformed(const glm::vec3& position, const glm::mat3& rotation) const;
     void expandToInclude(const BoundingBox& other);
     void expandToInclude(const glm::vec3& point);
-    void renderDebug(ShaderProgram &shader);
-private:
-    void setupBuffers();
-
-};
\ No newline at end of file
+};
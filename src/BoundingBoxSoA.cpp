@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cfloat>
+#include "BoundingBoxSoA.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BATTLEBEYZ_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BATTLEBEYZ_TARGET_AVX2
+#else
+#include <cpuid.h>
+#define BATTLEBEYZ_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+    using OverlapKernel = size_t (*)(const BoundingBoxSoA&, const BoundingBox&, uint32_t*);
+
+    uint32_t popCount(uint32_t bits) {
+        uint32_t n = 0;
+        for (; bits != 0; bits &= bits - 1) ++n;
+        return n;
+    }
+
+    size_t overlapScalar(const BoundingBoxSoA& set, const BoundingBox& q, uint32_t* masks) {
+        size_t hits = 0;
+        for (size_t i = 0; i < set.size(); ++i) {
+            bool overlap = set.minX[i] <= q.max.x && set.maxX[i] >= q.min.x &&
+                           set.minY[i] <= q.max.y && set.maxY[i] >= q.min.y &&
+                           set.minZ[i] <= q.max.z && set.maxZ[i] >= q.min.z;
+            if (overlap) {
+                masks[i >> 5] |= 1u << (i & 31);
+                ++hits;
+            }
+        }
+        return hits;
+    }
+
+#ifdef BATTLEBEYZ_X86
+    size_t overlapSSE(const BoundingBoxSoA& set, const BoundingBox& q, uint32_t* masks) {
+        const __m128 qMinX = _mm_set1_ps(q.min.x), qMaxX = _mm_set1_ps(q.max.x);
+        const __m128 qMinY = _mm_set1_ps(q.min.y), qMaxY = _mm_set1_ps(q.max.y);
+        const __m128 qMinZ = _mm_set1_ps(q.min.z), qMaxZ = _mm_set1_ps(q.max.z);
+
+        size_t hits = 0;
+        for (size_t i = 0; i < set.size(); i += 4) {
+            __m128 hit = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&set.minX[i]), qMaxX),
+                                    _mm_cmpge_ps(_mm_loadu_ps(&set.maxX[i]), qMinX));
+            hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_loadu_ps(&set.minY[i]), qMaxY));
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_loadu_ps(&set.maxY[i]), qMinY));
+            hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_loadu_ps(&set.minZ[i]), qMaxZ));
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_loadu_ps(&set.maxZ[i]), qMinZ));
+
+            auto bits = static_cast<uint32_t>(_mm_movemask_ps(hit));
+            if (bits != 0) {
+                masks[i >> 5] |= bits << (i & 31);
+                hits += popCount(bits);
+            }
+        }
+        return hits;
+    }
+
+    BATTLEBEYZ_TARGET_AVX2
+    size_t overlapAVX2(const BoundingBoxSoA& set, const BoundingBox& q, uint32_t* masks) {
+        const __m256 qMinX = _mm256_set1_ps(q.min.x), qMaxX = _mm256_set1_ps(q.max.x);
+        const __m256 qMinY = _mm256_set1_ps(q.min.y), qMaxY = _mm256_set1_ps(q.max.y);
+        const __m256 qMinZ = _mm256_set1_ps(q.min.z), qMaxZ = _mm256_set1_ps(q.max.z);
+
+        size_t hits = 0;
+        for (size_t i = 0; i < set.size(); i += 8) {
+            __m256 hit = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(&set.minX[i]), qMaxX, _CMP_LE_OQ),
+                                       _mm256_cmp_ps(_mm256_loadu_ps(&set.maxX[i]), qMinX, _CMP_GE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(&set.minY[i]), qMaxY, _CMP_LE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(&set.maxY[i]), qMinY, _CMP_GE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(&set.minZ[i]), qMaxZ, _CMP_LE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(&set.maxZ[i]), qMinZ, _CMP_GE_OQ));
+
+            auto bits = static_cast<uint32_t>(_mm256_movemask_ps(hit));
+            if (bits != 0) {
+                masks[i >> 5] |= bits << (i & 31);
+                hits += popCount(bits);
+            }
+        }
+        return hits;
+    }
+#endif
+
+    SimdLevel detectOnce() {
+#ifdef BATTLEBEYZ_X86
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+        __cpuid(info, 1);
+        bool sse2 = (info[3] & (1 << 26)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        bool avx2 = false;
+        if (maxLeaf >= 7 && osxsave && avx) {
+            // The OS also has to save the YMM registers on context switches
+            bool ymmEnabled = (_xgetbv(0) & 0x6) == 0x6;
+            __cpuidex(info, 7, 0);
+            avx2 = ymmEnabled && (info[1] & (1 << 5)) != 0;
+        }
+        if (avx2) return SimdLevel::AVX2;
+        if (sse2) return SimdLevel::SSE;
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE;
+#endif
+#endif
+        return SimdLevel::Scalar;
+    }
+
+    OverlapKernel kernelFor(SimdLevel level) {
+        switch (level) {
+#ifdef BATTLEBEYZ_X86
+            case SimdLevel::AVX2: return overlapAVX2;
+            case SimdLevel::SSE: return overlapSSE;
+#endif
+            default: return overlapScalar;
+        }
+    }
+
+    struct ActiveKernel {
+        SimdLevel level;
+        OverlapKernel kernel;
+    };
+
+    // Picked on first use rather than at static initialization, so overlapMask works even when called from
+    // another translation unit's static initializer
+    ActiveKernel& active() {
+        static ActiveKernel state{detectSimdLevel(), kernelFor(detectSimdLevel())};
+        return state;
+    }
+}
+
+SimdLevel detectSimdLevel() {
+    static const SimdLevel detected = detectOnce();
+    return detected;
+}
+
+SimdLevel getSimdLevel() {
+    return active().level;
+}
+
+void setSimdLevel(SimdLevel level) {
+    if (static_cast<int>(level) > static_cast<int>(detectSimdLevel())) {
+        level = detectSimdLevel();
+    }
+    active() = {level, kernelFor(level)};
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE: return "SSE";
+        default: return "Scalar";
+    }
+}
+
+void BoundingBoxSoA::clear() {
+    minX.clear(); minY.clear(); minZ.clear();
+    maxX.clear(); maxY.clear(); maxZ.clear();
+    count = 0;
+}
+
+void BoundingBoxSoA::assign(const std::vector<BoundingBox>& boxes) {
+    count = boxes.size();
+    size_t padded = (count + 7) & ~size_t(7);
+    minX.resize(padded); minY.resize(padded); minZ.resize(padded);
+    maxX.resize(padded); maxY.resize(padded); maxZ.resize(padded);
+    for (size_t i = 0; i < count; ++i) {
+        const BoundingBox& box = boxes[i];
+        minX[i] = box.min.x; minY[i] = box.min.y; minZ[i] = box.min.z;
+        maxX[i] = box.max.x; maxY[i] = box.max.y; maxZ[i] = box.max.z;
+    }
+    pad();
+}
+
+void BoundingBoxSoA::push_back(const BoundingBox& box) {
+    // Drop the padding, append, then pad again
+    minX.resize(count); minY.resize(count); minZ.resize(count);
+    maxX.resize(count); maxY.resize(count); maxZ.resize(count);
+    minX.push_back(box.min.x); minY.push_back(box.min.y); minZ.push_back(box.min.z);
+    maxX.push_back(box.max.x); maxY.push_back(box.max.y); maxZ.push_back(box.max.z);
+    ++count;
+    pad();
+}
+
+void BoundingBoxSoA::pad() {
+    // Empty boxes (min above max) never overlap anything, so the kernels can always run full lanes
+    size_t padded = (count + 7) & ~size_t(7);
+    minX.resize(padded); minY.resize(padded); minZ.resize(padded);
+    maxX.resize(padded); maxY.resize(padded); maxZ.resize(padded);
+    for (size_t i = count; i < padded; ++i) {
+        minX[i] = minY[i] = minZ[i] = FLT_MAX;
+        maxX[i] = maxY[i] = maxZ[i] = -FLT_MAX;
+    }
+}
+
+size_t BoundingBoxSoA::overlapMask(const BoundingBox& query, uint32_t* masks) const {
+    std::fill(masks, masks + maskWords(), 0u);
+    if (count == 0) return 0;
+    return active().kernel(*this, query, masks);
+}
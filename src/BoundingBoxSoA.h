@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "BoundingBox.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+enum class SimdLevel {
+    Scalar,
+    SSE,
+    AVX2
+};
+
+// Best level the CPU supports, detected once at startup
+SimdLevel detectSimdLevel();
+// Level used by BoundingBoxSoA::overlapMask. Requests above what the CPU supports are clamped.
+SimdLevel getSimdLevel();
+void setSimdLevel(SimdLevel level);
+const char* simdLevelName(SimdLevel level);
+
+inline uint32_t lowestSetBit(uint32_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctz(bits));
+#endif
+}
+
+// A set of boxes stored as separate min/max x/y/z arrays, so one query box can be tested against
+// 4 (SSE) or 8 (AVX2) candidates per instruction. Arrays are padded with empty boxes to a multiple of 8.
+class BoundingBoxSoA {
+public:
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    void clear();
+    void assign(const std::vector<BoundingBox>& boxes);
+    void push_back(const BoundingBox& box);
+
+    [[nodiscard]] size_t size() const { return count; }
+    [[nodiscard]] size_t maskWords() const { return (count + 31) / 32; }
+
+    // Sets bit i of masks[i / 32] when box i overlaps query. masks needs maskWords() entries.
+    // Returns the number of overlapping boxes.
+    size_t overlapMask(const BoundingBox& query, uint32_t* masks) const;
+
+    // Calls visit(index) for every box overlapping query, in index order. masks is scratch space for
+    // overlapMask, grown as needed and reused between calls so nothing is allocated once it is big enough.
+    template<typename Visitor>
+    void forEachOverlap(const BoundingBox& query, std::vector<uint32_t>& masks, Visitor&& visit) const;
+
+private:
+    size_t count = 0;
+
+    void pad();
+};
+
+template<typename Visitor>
+void BoundingBoxSoA::forEachOverlap(const BoundingBox& query, std::vector<uint32_t>& masks, Visitor&& visit) const {
+    if (masks.size() < maskWords()) masks.resize(maskWords());
+    if (overlapMask(query, masks.data()) == 0) return;
+
+    for (size_t word = 0; word < maskWords(); ++word) {
+        uint32_t bits = masks[word];
+        while (bits != 0) {
+            visit(word * 32 + lowestSetBit(bits));
+            bits &= bits - 1;
+        }
+    }
+}
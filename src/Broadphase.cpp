@@ -0,0 +1,22 @@
+#include <algorithm>
+#include "Broadphase.h"
+
+void BruteForceBroadphase::removeBody(RigidBody* body) {
+    bodies.erase(std::remove(bodies.begin(), bodies.end(), body), bodies.end());
+}
+
+void BruteForceBroadphase::clear() {
+    bodies.clear();
+    pairs.clear();
+}
+
+void BruteForceBroadphase::update() {
+    pairs.clear();
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        for (size_t j = i + 1; j < bodies.size(); ++j) {
+            if (bodies[i]->aggregateBoundingBox.checkCollision(bodies[j]->aggregateBoundingBox)) {
+                pairs.emplace_back(bodies[i], bodies[j]);
+            }
+        }
+    }
+}
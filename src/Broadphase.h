@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include "RigidBody.h"
+
+// Finds candidate body pairs whose aggregate bounds overlap. Implementations emit each pair once, with the
+// earlier-added body first, so results can be compared between broadphases.
+class Broadphase {
+public:
+    virtual ~Broadphase() = default;
+
+    virtual void addBody(RigidBody* body) = 0;
+    // Keeps the remaining bodies in the order they were added
+    virtual void removeBody(RigidBody* body) = 0;
+    // Drops every body but keeps allocated storage for the next ones
+    virtual void clear() = 0;
+    virtual void update() = 0;
+
+    [[nodiscard]] const std::vector<std::pair<RigidBody*, RigidBody*>>& getPairs() const { return pairs; }
+
+protected:
+    std::vector<std::pair<RigidBody*, RigidBody*>> pairs;
+};
+
+// Tests every pair of bodies. Kept as the reference to compare the other broadphases against.
+class BruteForceBroadphase : public Broadphase {
+public:
+    void addBody(RigidBody* body) override { bodies.push_back(body); }
+    void removeBody(RigidBody* body) override;
+    void clear() override;
+    void update() override;
+
+private:
+    std::vector<RigidBody*> bodies;
+};
@@ -27,6 +27,8 @@ struct CallbackData {
     ImFont* attackFont;
     bool boundCamera;
     ProgramState currentState;
+    std::vector<GameObject*> pickableObjects;  // Tested by mouse picking, nearest hit wins
+    PickResult hover;                          // What the cursor is over, refreshed on every mouse move
 
 
     CallbackData(int *width, int *height, float ratio, glm::mat4 *proj, ShaderProgram *sh, ShaderProgram* background,
@@ -32,6 +32,17 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     ImGui_ImplGlfw_CursorPosCallback(window, xpos, ypos);
     ImGuiIO& io = ImGui::GetIO();
 
+    // Hover picking, skipped while ImGui has the mouse or the camera is being turned
+    auto* hoverData = static_cast<CallbackData*>(glfwGetWindowUserPointer(window));
+    if (hoverData && hoverData->cameraState) {
+        hoverData->hover = {};
+        if (!io.WantCaptureMouse && glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) != GLFW_PRESS) {
+            Camera* camera = hoverData->cameraState->camera;
+            glm::vec3 ray_world = screenToWorldCoordinates(window, xpos, ypos, camera->getViewMatrix(), *hoverData->projection);
+            hoverData->hover = pickObject(hoverData->pickableObjects, camera->Position, ray_world);
+        }
+    }
+
     // Process camera movement only when the right mouse button is pressed and ImGui is not capturing the mouse
     if (!io.WantCaptureMouse || glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS) {
         auto* data = static_cast<CallbackData*>(glfwGetWindowUserPointer(window));
@@ -104,9 +115,11 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 
         glm::vec3 ray_world = screenToWorldCoordinates(window, xpos, ypos, data->cameraState->camera->getViewMatrix(), *data->projection);
 
-        // Assuming you have a function that checks intersection with objects in your scene
-        std::string clickedObject = checkIntersection(ray_world);
-        std::cout << "Left mouse button clicked! Ray: " << ray_world[0] << ", " << ray_world[1] << ", " << ray_world[2] << " Object: " << clickedObject << std::endl;
+        PickResult pick = pickObject(data->pickableObjects, data->cameraState->camera->Position, ray_world);
+        if (pick.object) {
+            std::cout << "Picked " << pick.object->name << ", triangle " << pick.triangle << " at "
+                      << pick.point.x << ", " << pick.point.y << ", " << pick.point.z << std::endl;
+        }
     }
 }
 
@@ -123,4 +136,13 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 //            glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 //        }
     }
-}
\ No newline at end of file
+}
+
+PlayerInput readPlayerInput(GLFWwindow* window, int left, int right, int forward, int back) {
+    PlayerInput input;
+    if (glfwGetKey(window, left) == GLFW_PRESS) input.buttons |= PlayerInput::Left;
+    if (glfwGetKey(window, right) == GLFW_PRESS) input.buttons |= PlayerInput::Right;
+    if (glfwGetKey(window, forward) == GLFW_PRESS) input.buttons |= PlayerInput::Forward;
+    if (glfwGetKey(window, back) == GLFW_PRESS) input.buttons |= PlayerInput::Back;
+    return input;
+}
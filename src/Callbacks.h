@@ -6,6 +6,7 @@
 #include "Utils.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
+#include "Match.h"
 
 // Define callbacks to be used in main
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -14,4 +15,6 @@ void processInput(GLFWwindow* window,float deltaTime);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+// Steer directions held on four keys, for one netplay player
+PlayerInput readPlayerInput(GLFWwindow* window, int left, int right, int forward, int back);
 
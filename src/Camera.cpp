@@ -6,13 +6,11 @@ Camera::Camera(const glm::vec3& position, float yaw, float pitch, float roll, Ph
         physicsWorld(world) {
     updateCameraVectors();
 
-    // Initialize the camera's rigid body
-    std::vector<BoundingBox*> bboxes;
-    bboxes.push_back(new BoundingBox(glm::vec3(position - glm::vec3(1.0f)), glm::vec3(position + glm::vec3(1.0f))));
-    body = new RigidBody(position, glm::vec3(0.02f), 0.79f, std::move(bboxes));
-
+    // Initialize the camera's rigid body. Without a world the camera moves freely and has no body.
     if (physicsWorld) {
-        physicsWorld->addBody(body);
+        body = physicsWorld->getBody(physicsWorld->createBody(position, glm::vec3(0.02f), 0.79f));
+        body->localBoxes.emplace_back(glm::vec3(-1.0f), glm::vec3(1.0f));
+        body->updateBoundingBoxes();
     }
 }
 
@@ -22,31 +20,15 @@ glm::mat4 Camera::getViewMatrix() const {
 }
 
 void Camera::applyBoundaries(glm::vec3& position) const {
-    if (!physicsWorld) return;
-
-    // Temporarily move the body's position to check for collisions
-    glm::vec3 originalPosition = body->position;
-    body->position = position;
-
-    std::cout << "Applying boundaries. New position: "
-              << position.x << ", " << position.y << ", " << position.z << "\n";
-
-    for (const auto& otherBody : physicsWorld->bodies) {
-        if (otherBody != body) {
-            for (const auto& boxA : body->boundingBoxes) {
-                for (const auto& boxB : otherBody->boundingBoxes) {
-                    if (boxA->checkCollision(*boxB)) {
-                        position = originalPosition; // Revert position if collision detected
-                        std::cout << "Collision detected. Reverting position to: "
-                                  << position.x << ", " << position.y << ", " << position.z << "\n";
-                        break;
-                    }
-                }
-            }
-        }
+    if (!physicsWorld || !body) return;
+
+    // The body's bounds moved to the new position, tested against everything else in the world
+    glm::vec3 offset = position - body->position;
+    BoundingBox moved(body->aggregateBoundingBox.min + offset, body->aggregateBoundingBox.max + offset);
+    RigidBody* hit;
+    if (physicsWorld->queryAABB(moved, &hit, 1, body) > 0) {
+        position = Position; // Stay put if the move would collide
     }
-
-    body->position = originalPosition; // Restore original position
 }
 
 void Camera::processKeyboard(int direction, float deltaTime, bool boundCamera) {
@@ -82,7 +64,7 @@ void Camera::processKeyboard(int direction, float deltaTime, bool boundCamera) {
         Zoom = 1.0f;
     }
 
-    if (!isMoving) {
+    if (!isMoving && body) {
         body->velocity = glm::vec3(0.0f);
     }
 
@@ -91,11 +73,10 @@ void Camera::processKeyboard(int direction, float deltaTime, bool boundCamera) {
     }
 
     Position = newPosition;
-    std::cout << "Camera position: " << Position.x << ", " << Position.y << ", " << Position.z << std::endl;
     // Update the body's position to match the camera
+    if (!body) return;
     body->position = Position;
     body->updateBoundingBoxes();
-    std::cout << "Body position: " << body->position.x << ", " << body->position.y << ", " << body->position.z << std::endl;
 }
 
 void Camera::processMouseMovement(float xoffset, float yoffset, GLboolean constrainPitch) {
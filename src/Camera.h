@@ -29,8 +29,8 @@ public:
     float MouseSensitivity;
     float Zoom;
 
-    // Camera rigid body
-    RigidBody* body;
+    // Camera rigid body, owned by the world. nullptr without one.
+    RigidBody* body = nullptr;
     PhysicsWorld* physicsWorld;
 
     // Camera matrices
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+class RigidBody;
+
+// One touching point found by the narrowphase. Box pairs use the axis and size of their smallest overlap;
+// analytic colliders fill in the real surface contact.
+struct Contact {
+    RigidBody* bodyA;
+    RigidBody* bodyB;
+    glm::vec3 point;
+    glm::vec3 normal;  // From A towards B
+    float depth;       // Penetration along normal
+    bool boxOverlap;   // From two overlapping boxes, world-space AABBs of each body's rotated local boxes
+};
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cfloat>
+#include "ContactManifold.h"
+#include "RigidBody.h"
+
+namespace {
+    // Points closer than this to one from the previous step are treated as the same point
+    constexpr float kMatchDistance = 0.02f;
+
+    uint64_t hashKey(uint64_t key) {
+        // splitmix64 finalizer: body ids are small and sequential, so spread them over the whole table
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ull;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebull;
+        key ^= key >> 31;
+        return key;
+    }
+
+    float triangleArea(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+        return glm::length(glm::cross(b - a, c - a));
+    }
+}
+
+void buildManifold(const Contact* contacts, size_t count, ContactManifold& manifold) {
+    manifold.bodyA = contacts[0].bodyA;
+    manifold.bodyB = contacts[0].bodyB;
+    manifold.boxOverlap = contacts[0].boxOverlap;
+    manifold.pointCount = 0;
+
+    // Box contacts can disagree on their axis, so the shared normal is their depth-weighted average
+    glm::vec3 normalSum(0.0f);
+    for (size_t i = 0; i < count; ++i) {
+        normalSum += contacts[i].normal * std::max(contacts[i].depth, FLT_EPSILON);
+    }
+    float length = glm::length(normalSum);
+    manifold.normal = length > FLT_EPSILON ? normalSum / length : contacts[0].normal;
+
+    auto addPoint = [&](size_t index) {
+        manifold.points[manifold.pointCount++] = {contacts[index].point, contacts[index].depth, 0.0f, {0.0f, 0.0f}};
+    };
+
+    // Deepest first, so the point that matters most is always kept
+    size_t deepest = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (contacts[i].depth > contacts[deepest].depth) deepest = i;
+    }
+    addPoint(deepest);
+    if (count == 1) return;
+
+    size_t farthest = deepest;
+    float bestDistance = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float distance = glm::dot(contacts[i].point - contacts[deepest].point, contacts[i].point - contacts[deepest].point);
+        if (distance > bestDistance) {
+            bestDistance = distance;
+            farthest = i;
+        }
+    }
+    if (farthest == deepest) return;  // Every point is in the same place
+    addPoint(farthest);
+
+    // Then the points that widen the patch the most
+    while (manifold.pointCount < ContactManifold::kMaxPoints) {
+        size_t best = count;
+        float bestArea = FLT_EPSILON;
+        for (size_t i = 0; i < count; ++i) {
+            const glm::vec3& p = contacts[i].point;
+            float area = FLT_MAX;
+            // Area added is bounded by the smallest triangle it forms with any edge of the current patch
+            for (uint32_t a = 0; a < manifold.pointCount; ++a) {
+                uint32_t b = (a + 1) % manifold.pointCount;
+                area = std::min(area, triangleArea(manifold.points[a].point, manifold.points[b].point, p));
+            }
+            if (area > bestArea) {
+                bestArea = area;
+                best = i;
+            }
+        }
+        if (best == count) break;
+        addPoint(best);
+    }
+}
+
+uint64_t ContactCache::pairKey(const RigidBody* bodyA, const RigidBody* bodyB) {
+    return (static_cast<uint64_t>(bodyA->id) << 32) | bodyB->id;
+}
+
+void ContactCache::beginStep() {
+    std::swap(manifolds, previousManifolds);
+    manifolds.clear();
+    buildTable();
+}
+
+void ContactCache::removeBody(const RigidBody* body) {
+    // Only the current list matters: beginStep turns it into the previous one and rebuilds the table from it
+    manifolds.erase(std::remove_if(manifolds.begin(), manifolds.end(), [&](const ContactManifold& manifold) {
+        return manifold.bodyA == body || manifold.bodyB == body;
+    }), manifolds.end());
+}
+
+void ContactCache::clear() {
+    manifolds.clear();
+    previousManifolds.clear();
+    buildTable();
+}
+
+void ContactCache::buildTable() {
+    size_t capacity = 16;
+    while (capacity < previousManifolds.size() * 2) capacity *= 2;
+    tableKeys.assign(capacity, kEmptyKey);
+    tableManifolds.resize(capacity);
+
+    size_t mask = capacity - 1;
+    for (uint32_t i = 0; i < previousManifolds.size(); ++i) {
+        uint64_t key = pairKey(previousManifolds[i].bodyA, previousManifolds[i].bodyB);
+        size_t slot = hashKey(key) & mask;
+        while (tableKeys[slot] != kEmptyKey && tableKeys[slot] != key) {
+            slot = (slot + 1) & mask;
+        }
+        tableKeys[slot] = key;
+        tableManifolds[slot] = i;
+    }
+}
+
+const ContactManifold* ContactCache::findPrevious(const RigidBody* bodyA, const RigidBody* bodyB) const {
+    if (previousManifolds.empty()) return nullptr;
+
+    uint64_t key = pairKey(bodyA, bodyB);
+    size_t mask = tableKeys.size() - 1;
+    for (size_t slot = hashKey(key) & mask; tableKeys[slot] != kEmptyKey; slot = (slot + 1) & mask) {
+        if (tableKeys[slot] == key) {
+            return &previousManifolds[tableManifolds[slot]];
+        }
+    }
+    return nullptr;
+}
+
+ContactManifold& ContactCache::add(const ContactManifold& manifold) {
+    manifolds.push_back(manifold);
+    ContactManifold& added = manifolds.back();
+
+    const ContactManifold* previous = findPrevious(added.bodyA, added.bodyB);
+    if (!previous) return added;
+
+    for (uint32_t i = 0; i < added.pointCount; ++i) {
+        ManifoldPoint& point = added.points[i];
+        float bestDistance = kMatchDistance * kMatchDistance;
+        for (uint32_t j = 0; j < previous->pointCount; ++j) {
+            glm::vec3 offset = previous->points[j].point - point.point;
+            float distance = glm::dot(offset, offset);
+            if (distance <= bestDistance) {
+                bestDistance = distance;
+                point.normalImpulse = previous->points[j].normalImpulse;
+                point.tangentImpulse[0] = previous->points[j].tangentImpulse[0];
+                point.tangentImpulse[1] = previous->points[j].tangentImpulse[1];
+            }
+        }
+    }
+    return added;
+}
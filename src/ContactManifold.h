@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Contact.h"
+
+class RigidBody;
+
+struct ManifoldPoint {
+    glm::vec3 point;
+    float depth;
+    float normalImpulse;  // Accumulated over the step, carried into the next one for warm starting
+    float tangentImpulse[2];
+};
+
+// Every contact between one pair of bodies in one step, reduced to at most four points that share a normal
+struct ContactManifold {
+    static constexpr uint32_t kMaxPoints = 4;
+
+    RigidBody* bodyA;
+    RigidBody* bodyB;
+    glm::vec3 normal;  // From A towards B
+    bool boxOverlap;   // Built from box overlaps, see Contact
+    uint32_t pointCount;
+    ManifoldPoint points[kMaxPoints];
+};
+
+// Reduces a run of contacts between the same two bodies to one manifold: the deepest point, the point farthest
+// from it, then the two that add the most area. Impulses start at zero.
+void buildManifold(const Contact* contacts, size_t count, ContactManifold& manifold);
+
+// Manifolds for the current step, plus the previous step's so their impulses can warm start the new ones.
+// Pairs are keyed by body id, which stays the same for a body's lifetime in the world. Ids are reused after a
+// body is destroyed, so removeBody has to drop its manifolds before the id comes back. The previous step's
+// manifolds are indexed by a flat open-addressing table that is rebuilt once per step and only ever read.
+class ContactCache {
+public:
+    // Moves the current manifolds to the previous step and starts an empty list
+    void beginStep();
+    // Adds a manifold for this step, with impulses copied from last step's points that are close enough
+    ContactManifold& add(const ContactManifold& manifold);
+    // Forgets every manifold involving the body, so nothing warm starts from it
+    void removeBody(const RigidBody* body);
+    void clear();
+
+    [[nodiscard]] const ContactManifold* findPrevious(const RigidBody* bodyA, const RigidBody* bodyB) const;
+    [[nodiscard]] std::vector<ContactManifold>& getManifolds() { return manifolds; }
+    [[nodiscard]] const std::vector<ContactManifold>& getManifolds() const { return manifolds; }
+
+private:
+    static constexpr uint64_t kEmptyKey = ~0ull;
+
+    std::vector<ContactManifold> manifolds;
+    std::vector<ContactManifold> previousManifolds;
+    std::vector<uint64_t> tableKeys;       // Power-of-two sized, kEmptyKey marks a free slot
+    std::vector<uint32_t> tableManifolds;  // Index into previousManifolds for each occupied slot
+
+    static uint64_t pairKey(const RigidBody* bodyA, const RigidBody* bodyB);
+    void buildTable();
+};
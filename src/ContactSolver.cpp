@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "ContactSolver.h"
+#include "RigidBody.h"
+
+namespace {
+    float effectiveMass(float inverseMassSum, const glm::mat3& inverseInertiaA, const glm::mat3& inverseInertiaB,
+                        const glm::vec3& rA, const glm::vec3& rB, const glm::vec3& direction) {
+        glm::vec3 rnA = glm::cross(rA, direction);
+        glm::vec3 rnB = glm::cross(rB, direction);
+        float k = inverseMassSum + glm::dot(rnA, inverseInertiaA * rnA) + glm::dot(rnB, inverseInertiaB * rnB);
+        return k > 0.0f ? 1.0f / k : 0.0f;
+    }
+
+    // Any fixed basis works, as long as it only depends on the normal so warm started impulses stay meaningful
+    void tangentBasis(const glm::vec3& normal, glm::vec3& tangent1, glm::vec3& tangent2) {
+        if (std::abs(normal.x) >= 0.57735f) {
+            tangent1 = glm::normalize(glm::vec3(normal.y, -normal.x, 0.0f));
+        } else {
+            tangent1 = glm::normalize(glm::vec3(0.0f, normal.z, -normal.y));
+        }
+        tangent2 = glm::cross(normal, tangent1);
+    }
+}
+
+uint32_t ContactSolver::slotFor(RigidBody* body) {
+    if (body->id >= bodySlots.size()) {
+        bodySlots.resize(body->id + 1, -1);
+    }
+    int32_t& slot = bodySlots[body->id];
+    if (slot < 0) {
+        slot = static_cast<int32_t>(solverBodies.size());
+        // Immovable bodies have FLT_MAX mass and must not pick up any velocity
+        bool movable = body->mass < FLT_MAX;
+        solverBodies.push_back({body, body->velocity, body->angularVelocity, glm::vec3(0.0f),
+                                movable ? 1.0f / body->mass : 0.0f,
+                                movable ? body->inverseInertiaTensor : glm::mat3(0.0f)});
+    }
+    return static_cast<uint32_t>(slot);
+}
+
+void ContactSolver::prepare(std::vector<ContactManifold>& manifolds, const SolverSettings& settings) {
+    solverBodies.clear();
+    rows.clear();
+
+    for (ContactManifold& manifold : manifolds) {
+        uint32_t a = slotFor(manifold.bodyA);
+        uint32_t b = slotFor(manifold.bodyB);
+        const SolverBody& bodyA = solverBodies[a];
+        const SolverBody& bodyB = solverBodies[b];
+        float inverseMassSum = bodyA.inverseMass + bodyB.inverseMass;
+        if (inverseMassSum == 0.0f) continue;
+
+        float friction = std::sqrt(manifold.bodyA->friction * manifold.bodyB->friction);
+        for (uint32_t i = 0; i < manifold.pointCount; ++i) {
+            ManifoldPoint& point = manifold.points[i];
+            ContactRow row{};
+            row.bodyA = a;
+            row.bodyB = b;
+            row.normal = manifold.normal;
+            tangentBasis(row.normal, row.tangent1, row.tangent2);
+            row.rA = point.point - manifold.bodyA->position;
+            row.rB = point.point - manifold.bodyB->position;
+            if (manifold.boxOverlap) {
+                // The boxes are world-space AABBs around the rotated local boxes, so where they touch only loosely
+                // follows the real surface and says nothing about the lever arm. Act through the centre of mass
+                // along the normal instead.
+                row.rA = row.normal * glm::dot(row.normal, row.rA);
+                row.rB = row.normal * glm::dot(row.normal, row.rB);
+            }
+            row.normalMass = effectiveMass(inverseMassSum, bodyA.inverseInertia, bodyB.inverseInertia, row.rA, row.rB, row.normal);
+            row.tangentMass1 = effectiveMass(inverseMassSum, bodyA.inverseInertia, bodyB.inverseInertia, row.rA, row.rB, row.tangent1);
+            row.tangentMass2 = effectiveMass(inverseMassSum, bodyA.inverseInertia, bodyB.inverseInertia, row.rA, row.rB, row.tangent2);
+            row.friction = friction;
+            row.depth = point.depth;
+            row.normalImpulse = point.normalImpulse;
+            row.tangentImpulse1 = point.tangentImpulse[0];
+            row.tangentImpulse2 = point.tangentImpulse[1];
+            row.source = &point;
+
+            // Bounce off the approach speed from before warm starting
+            glm::vec3 relative = bodyB.velocity + glm::cross(bodyB.angularVelocity, row.rB) -
+                                 bodyA.velocity - glm::cross(bodyA.angularVelocity, row.rA);
+            float approach = glm::dot(relative, row.normal);
+            row.velocityBias = approach < -settings.restitutionThreshold ? -settings.restitution * approach : 0.0f;
+            rows.push_back(row);
+        }
+    }
+
+    // Leave the slot table clean for the next step
+    for (const SolverBody& body : solverBodies) {
+        bodySlots[body.body->id] = -1;
+    }
+}
+
+void ContactSolver::warmStart() {
+    for (const ContactRow& row : rows) {
+        SolverBody& a = solverBodies[row.bodyA];
+        SolverBody& b = solverBodies[row.bodyB];
+        glm::vec3 impulse = row.normal * row.normalImpulse + row.tangent1 * row.tangentImpulse1 +
+                            row.tangent2 * row.tangentImpulse2;
+        a.velocity -= impulse * a.inverseMass;
+        a.angularVelocity -= a.inverseInertia * glm::cross(row.rA, impulse);
+        b.velocity += impulse * b.inverseMass;
+        b.angularVelocity += b.inverseInertia * glm::cross(row.rB, impulse);
+    }
+}
+
+float ContactSolver::solveVelocities() {
+    float residual = 0.0f;
+    for (ContactRow& row : rows) {
+        SolverBody& a = solverBodies[row.bodyA];
+        SolverBody& b = solverBodies[row.bodyB];
+        auto apply = [&](const glm::vec3& impulse) {
+            a.velocity -= impulse * a.inverseMass;
+            a.angularVelocity -= a.inverseInertia * glm::cross(row.rA, impulse);
+            b.velocity += impulse * b.inverseMass;
+            b.angularVelocity += b.inverseInertia * glm::cross(row.rB, impulse);
+        };
+        auto relativeVelocity = [&]() {
+            return b.velocity + glm::cross(b.angularVelocity, row.rB) - a.velocity - glm::cross(a.angularVelocity, row.rA);
+        };
+
+        // Friction first, limited to a circle of radius friction * normal impulse
+        glm::vec3 relative = relativeVelocity();
+        float old1 = row.tangentImpulse1;
+        float old2 = row.tangentImpulse2;
+        float new1 = old1 - glm::dot(relative, row.tangent1) * row.tangentMass1;
+        float new2 = old2 - glm::dot(relative, row.tangent2) * row.tangentMass2;
+        float limit = row.friction * row.normalImpulse;
+        float length = std::sqrt(new1 * new1 + new2 * new2);
+        if (length > limit) {
+            float scale = length > 0.0f ? limit / length : 0.0f;
+            new1 *= scale;
+            new2 *= scale;
+        }
+        row.tangentImpulse1 = new1;
+        row.tangentImpulse2 = new2;
+        apply(row.tangent1 * (new1 - old1) + row.tangent2 * (new2 - old2));
+
+        // Then the normal, whose total impulse may only push
+        float velocityAlongNormal = glm::dot(relativeVelocity(), row.normal);
+        float lambda = (row.velocityBias - velocityAlongNormal) * row.normalMass;
+        float accumulated = std::max(row.normalImpulse + lambda, 0.0f);
+        lambda = accumulated - row.normalImpulse;
+        row.normalImpulse = accumulated;
+        apply(row.normal * lambda);
+        residual = std::max(residual, std::abs(lambda));
+    }
+    return residual;
+}
+
+void ContactSolver::solvePositions(const SolverSettings& settings) {
+    // Linear only: each point sees the corrections already made for the points before it
+    for (const ContactRow& row : rows) {
+        SolverBody& a = solverBodies[row.bodyA];
+        SolverBody& b = solverBodies[row.bodyB];
+        float inverseMassSum = a.inverseMass + b.inverseMass;
+        float depth = row.depth - glm::dot(b.positionDelta - a.positionDelta, row.normal);
+        if (depth <= settings.slop) continue;
+
+        glm::vec3 correction = row.normal * ((depth - settings.slop) * settings.correctionPercent / inverseMassSum);
+        a.positionDelta -= correction * a.inverseMass;
+        b.positionDelta += correction * b.inverseMass;
+    }
+}
+
+void ContactSolver::storeResults() {
+    for (const ContactRow& row : rows) {
+        row.source->normalImpulse = row.normalImpulse;
+        row.source->tangentImpulse[0] = row.tangentImpulse1;
+        row.source->tangentImpulse[1] = row.tangentImpulse2;
+    }
+    for (const SolverBody& solverBody : solverBodies) {
+        if (solverBody.inverseMass == 0.0f) continue;
+        RigidBody* body = solverBody.body;
+        body->velocity = solverBody.velocity;
+        body->angularVelocity = solverBody.angularVelocity;
+        if (solverBody.positionDelta != glm::vec3(0.0f)) {
+            // Keep the boxes on the body, which may fall asleep now and not be integrated again for a while
+            body->position += solverBody.positionDelta;
+            body->updateBoundingBoxes();
+        }
+    }
+}
+
+void ContactSolver::solve(std::vector<ContactManifold>& manifolds, const SolverSettings& settings) {
+    auto start = std::chrono::steady_clock::now();
+
+    prepare(manifolds, settings);
+    warmStart();
+    float residual = 0.0f;
+    for (int i = 0; i < settings.velocityIterations; ++i) {
+        residual = solveVelocities();
+    }
+    for (int i = 0; i < settings.positionIterations; ++i) {
+        solvePositions(settings);
+    }
+    storeResults();
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.residual = residual;
+    stats.rows = static_cast<uint32_t>(rows.size());
+    stats.bodies = static_cast<uint32_t>(solverBodies.size());
+}
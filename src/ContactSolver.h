@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ContactManifold.h"
+
+class RigidBody;
+
+struct SolverSettings {
+    int velocityIterations = 8;
+    int positionIterations = 1;       // Passes of position correction after the velocity iterations
+    float restitution = 0.5f;
+    float restitutionThreshold = 0.5f;  // Slower approaches do not bounce, so resting contacts settle
+    float correctionPercent = 0.8f;   // Fraction of the penetration removed per position pass
+    float slop = 0.001f;              // Penetration left alone so resting contacts stay touching
+};
+
+struct SolverStats {
+    double seconds = 0.0;
+    float residual = 0.0f;     // Largest normal impulse change in the last velocity iteration
+    uint32_t rows = 0;         // One per manifold point
+    uint32_t bodies = 0;
+};
+
+// Sequential impulse solver over every manifold point, with friction. Bodies and contact rows are copied
+// into contiguous arrays first, so the iterations only touch packed data. Impulses are warm started from the
+// manifolds and written back to them for the next step.
+class ContactSolver {
+public:
+    void solve(std::vector<ContactManifold>& manifolds, const SolverSettings& settings);
+    [[nodiscard]] const SolverStats& getStats() const { return stats; }
+
+private:
+    struct SolverBody {
+        RigidBody* body;
+        glm::vec3 velocity;
+        glm::vec3 angularVelocity;
+        glm::vec3 positionDelta;  // Accumulated by the position passes
+        float inverseMass;
+        glm::mat3 inverseInertia;
+    };
+
+    struct ContactRow {
+        uint32_t bodyA;
+        uint32_t bodyB;
+        glm::vec3 normal;
+        glm::vec3 tangent1;
+        glm::vec3 tangent2;
+        glm::vec3 rA;  // Contact point relative to each body's position
+        glm::vec3 rB;
+        float normalMass;
+        float tangentMass1;
+        float tangentMass2;
+        float velocityBias;
+        float friction;
+        float depth;
+        float normalImpulse;
+        float tangentImpulse1;
+        float tangentImpulse2;
+        ManifoldPoint* source;
+    };
+
+    std::vector<SolverBody> solverBodies;
+    std::vector<ContactRow> rows;
+    std::vector<int32_t> bodySlots;  // Indexed by body id, -1 when the body has no slot this step
+    SolverStats stats;
+
+    uint32_t slotFor(RigidBody* body);
+    void prepare(std::vector<ContactManifold>& manifolds, const SolverSettings& settings);
+    void warmStart();
+    float solveVelocities();
+    void solvePositions(const SolverSettings& settings);
+    void storeResults();
+};
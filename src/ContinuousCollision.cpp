@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <vector>
+#include "ContinuousCollision.h"
+
+namespace {
+    constexpr int kMaxIterations = 32;
+
+    // Signed distance from a sphere to the nearest box and the direction to push it out
+    float distanceToBoxes(const glm::vec3& center, float radius, const std::vector<BoundingBox>& boxes,
+                          const std::vector<uint32_t>& candidates, glm::vec3& normal) {
+        float best = FLT_MAX;
+        for (uint32_t index : candidates) {
+            const BoundingBox& box = boxes[index];
+            glm::vec3 offset = center - glm::clamp(center, box.min, box.max);
+            float distance = glm::length(offset);
+            if (distance - radius < best) {
+                best = distance - radius;
+                // A centre inside the box has no direction to the surface, fall back to pointing up
+                normal = distance > 0.0f ? offset / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+        }
+        return best;
+    }
+
+    // Advances t until distance(t) drops below tolerance. closingSpeed bounds how fast the distance can shrink
+    // per unit of t.
+    template<typename DistanceFunction>
+    bool advance(float closingSpeed, float tolerance, DistanceFunction&& distance, SweepHit& hit) {
+        glm::vec3 normal(0.0f, 1.0f, 0.0f);
+        float separation = distance(0.0f, normal);
+        if (separation <= tolerance || closingSpeed <= 0.0f) return false;
+
+        float t = 0.0f;
+        for (int i = 0; i < kMaxIterations; ++i) {
+            t += separation / closingSpeed;
+            if (t > 1.0f) return false;
+            separation = distance(t, normal);
+            if (separation <= tolerance) {
+                hit = {t, normal, separation};
+                return true;
+            }
+        }
+        // Still closing in after every iteration: report the last safe time
+        hit = {t, normal, separation};
+        return true;
+    }
+}
+
+float sweepRadius(const RigidBody& body) {
+    if (body.shape.type != ShapeType::None) return body.shape.radius;
+    const BoundingBox& bounds = body.aggregateBoundingBox;
+    return glm::length(glm::max(bounds.max - body.position, body.position - bounds.min));
+}
+
+bool sweepBody(const RigidBody& body, const RigidBody& other, float tolerance, SweepHit& hit, SweepScratch& scratch) {
+    glm::vec3 start = body.previousPosition;
+    glm::vec3 motion = body.position - body.previousPosition;
+    float radius = sweepRadius(body);
+
+    if (other.getStadiumCollider() && body.shape.type != ShapeType::None) {
+        const StadiumCollider& stadium = *other.getStadiumCollider();
+        glm::vec3 axis = body.orientation * glm::vec3(0.0f, 1.0f, 0.0f);
+        return advance(glm::length(motion), tolerance, [&](float t, glm::vec3& normal) {
+            StadiumContact contact{};
+            glm::vec3 center = start + motion * t;
+            if (body.shape.type == ShapeType::Disc) {
+                stadium.collideDisc(center, axis, body.shape.radius, contact);
+            } else {
+                stadium.collideSphere(center, body.shape.radius, contact);
+            }
+            normal = contact.normal;
+            return -contact.depth;
+        }, hit);
+    }
+
+    if (other.mass < FLT_MAX) {
+        // Two moving spheres, in the frame of the other body
+        glm::vec3 otherStart = other.previousPosition;
+        glm::vec3 otherMotion = other.position - other.previousPosition;
+        float radii = radius + sweepRadius(other);
+        return advance(glm::length(motion - otherMotion), tolerance, [&](float t, glm::vec3& normal) {
+            glm::vec3 offset = (start + motion * t) - (otherStart + otherMotion * t);
+            float distance = glm::length(offset);
+            if (distance > 0.0f) normal = offset / distance;
+            return distance - radii;
+        }, hit);
+    }
+
+    // Static boxes: only the ones near the swept path can be hit
+    glm::vec3 sweptMin = glm::min(start, body.position) - glm::vec3(radius + tolerance);
+    glm::vec3 sweptMax = glm::max(start, body.position) + glm::vec3(radius + tolerance);
+    std::vector<uint32_t>& candidates = scratch.candidates;
+    candidates.clear();
+    if (const BVH* tree = other.getBoxTree()) {
+        tree->query(sweptMin, sweptMax, [&](uint32_t index) { candidates.push_back(index); });
+    } else {
+        other.getCollisionBoxSet().forEachOverlap(BoundingBox(sweptMin, sweptMax), scratch.masks, [&](size_t index) {
+            candidates.push_back(static_cast<uint32_t>(index));
+        });
+    }
+    if (candidates.empty()) return false;
+
+    return advance(glm::length(motion), tolerance, [&](float t, glm::vec3& normal) {
+        return distanceToBoxes(start + motion * t, radius, other.getCollisionBoxes(), candidates, normal);
+    }, hit);
+}
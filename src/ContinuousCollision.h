@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "RigidBody.h"
+
+// Swept-sphere time of impact by conservative advancement. Each body moves in a straight line from its
+// previousPosition to its position over the step. Time advances by the current separation divided by an upper
+// bound on the closing speed, so it can never step past the first contact.
+
+struct SweepHit {
+    float time;        // Fraction of the step at first contact, in [0, 1]
+    glm::vec3 normal;  // From other towards body at that time
+    float separation;  // Gap left at that time, at most the tolerance
+};
+
+// Radius of the sphere swept for a body: its shape if it has one, otherwise one enclosing its boxes
+float sweepRadius(const RigidBody& body);
+
+// Reused between sweepBody calls, so sweeping against boxes allocates nothing once these have grown
+struct SweepScratch {
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> masks;
+};
+
+// First contact between the moving body and other during the last step. Pairs already touching at the start
+// of the step are left to the discrete narrowphase.
+bool sweepBody(const RigidBody& body, const RigidBody& other, float tolerance, SweepHit& hit, SweepScratch& scratch);
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include "DebugRenderer.h"
+#include "Buffers.h"
+#include "Utils.h"
+
+DebugRenderer::~DebugRenderer() {
+    if (VAO != 0) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+    }
+}
+
+void DebugRenderer::addBox(const BoundingBox& box) {
+    const glm::vec3& min = box.min;
+    const glm::vec3& max = box.max;
+    glm::vec3 corners[8] = {
+            {min.x, min.y, min.z}, {max.x, min.y, min.z}, {max.x, max.y, min.z}, {min.x, max.y, min.z},
+            {min.x, min.y, max.z}, {max.x, min.y, max.z}, {max.x, max.y, max.z}, {min.x, max.y, max.z}
+    };
+
+    auto base = static_cast<unsigned int>(vertexData.size() / 11);
+    for (const auto& corner : corners) {
+        // Positions, normals, texture coordinates, colors (same layout as setupBuffers)
+        vertexData.insert(vertexData.end(), {corner.x, corner.y, corner.z, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f});
+    }
+
+    const unsigned int edges[] = {
+            0, 1, 1, 2, 2, 3, 3, 0,  // Bottom face
+            4, 5, 5, 6, 6, 7, 7, 4,  // Top face
+            0, 4, 1, 5, 2, 6, 3, 7   // Connecting edges
+    };
+    for (unsigned int edge : edges) {
+        indices.push_back(base + edge);
+    }
+}
+
+void DebugRenderer::render(const PhysicsWorld& world, ShaderProgram& shader) {
+    vertexData.clear();
+    indices.clear();
+    for (const RigidBody* body : world.bodies) {
+        const std::vector<BoundingBox>& boxes = body->getCollisionBoxes();
+        size_t count = std::min(boxes.size(), maxBoxesPerBody);
+        for (size_t i = 0; i < count; ++i) {
+            addBox(boxes[i]);
+        }
+    }
+    if (indices.empty()) return;
+
+    // Attribute layout only needs to be set up once; after that the buffers are just refilled
+    if (VAO == 0) {
+        ::setupBuffers(VAO, VBO, EBO, nullptr, 0, nullptr, 0);
+    }
+
+    shader.use();
+    shader.setUniformMat4("model", glm::mat4(1.0f));
+    shader.setUniformVec3("objectColor", glm::vec3(1.0f, 1.0f, 1.0f));
+
+    GL_CHECK(glBindVertexArray(VAO));
+    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, VBO));
+    GL_CHECK(glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_DYNAMIC_DRAW));
+    GL_CHECK(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_DYNAMIC_DRAW));
+    GL_CHECK(glDrawElements(GL_LINES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, nullptr));
+    GL_CHECK(glBindVertexArray(0));
+}
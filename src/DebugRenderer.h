@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+#include <GL/glew.h>
+#include "ShaderProgram.h"
+#include "PhysicsWorld.h"
+
+// Draws the collision boxes of a PhysicsWorld as wireframes. One set of GL buffers is created on the first draw
+// and refilled every frame, so the physics side never owns GPU objects.
+class DebugRenderer {
+public:
+    size_t maxBoxesPerBody = 100;  // The stadium alone has over a thousand triangle boxes
+
+    DebugRenderer() = default;
+    ~DebugRenderer();
+
+    void render(const PhysicsWorld& world, ShaderProgram& shader);
+
+private:
+    GLuint VAO = 0, VBO = 0, EBO = 0;
+    std::vector<float> vertexData;
+    std::vector<unsigned int> indices;
+
+    void addBox(const BoundingBox& box);
+};
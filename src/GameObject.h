@@ -7,16 +7,37 @@
 #include <glm/gtc/type_ptr.hpp>
 #include "ShaderProgram.h"
 #include "Buffers.h"
+#include "TriangleBVH.h"
 #include <iostream>
+#include <string>
 
 class GameObject {
 public:
     GameObject(unsigned int vao, unsigned int vbo, unsigned int ebo, const glm::vec3& pos, const glm::vec3& col)
             : VAO(vao), VBO(vbo), EBO(ebo), position(pos), color(col) {}
 
+    virtual ~GameObject() = default;
+
     // Pure virtual functions
     virtual void initializeMesh() = 0;
     virtual void render(ShaderProgram &shader, const glm::vec3 &lightColor, const glm::vec3 &lightPos) = 0;
+
+    [[nodiscard]] virtual glm::mat4 getModelMatrix() const { return glm::translate(glm::mat4(1.0f), position); }
+
+    // Closest triangle of the mesh hit by a world space ray. The hit point is in world space, and distance is
+    // along direction, so a world distance when direction is normalized.
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, TriangleHit& hit) const {
+        if (pickTree.empty()) return false;
+        glm::mat4 model = getModelMatrix();
+        glm::mat4 inverseModel = glm::inverse(model);
+        glm::vec3 localOrigin = glm::vec3(inverseModel * glm::vec4(origin, 1.0f));
+        glm::vec3 localDirection = glm::vec3(inverseModel * glm::vec4(direction, 0.0f));
+        if (!pickTree.raycast(localOrigin, localDirection, maxDistance, hit)) return false;
+        hit.point = glm::vec3(model * glm::vec4(hit.point, 1.0f));
+        return true;
+    }
+
+    std::string name;  // Shown when the object is picked
 protected:
     // Mesh data
     std::vector<glm::vec3> vertices;
@@ -27,6 +48,7 @@ protected:
     std::vector<glm::vec3> colors;
 
     std::vector<float> vertexData;
+    TriangleBVH pickTree;  // Over vertices and indices in model space, built once the mesh is loaded
 
     unsigned int VAO, VBO, EBO;
     // Should migrate this position to RigidBody class
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include "JobSystem.h"
+
+JobSystem::JobSystem(unsigned workerCount) {
+    if (workerCount == 0) {
+        unsigned hardware = std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 0;
+    }
+
+    for (unsigned i = 0; i <= workerCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 1; i <= workerCount; ++i) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+bool JobSystem::runOneJob(unsigned threadIndex) {
+    Job job{};
+    bool found = false;
+
+    // Own work first, newest first, while it is still warm in cache
+    {
+        Queue& own = *queues[threadIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            found = true;
+        }
+    }
+
+    // Otherwise steal the oldest job from someone else
+    for (unsigned offset = 1; !found && offset < queues.size(); ++offset) {
+        Queue& victim = *queues[(threadIndex + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            found = true;
+        }
+    }
+
+    if (!found) return false;
+
+    queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    (*job.fn)(job.begin, job.end, threadIndex);
+    job.remaining->fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+void JobSystem::workerLoop(unsigned threadIndex) {
+    while (true) {
+        if (runOneJob(threadIndex)) continue;
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wakeCondition.wait(lock, [this]() { return stopping || queuedJobs.load(std::memory_order_relaxed) > 0; });
+        if (stopping) return;
+    }
+}
+
+void JobSystem::parallelFor(size_t count, size_t chunkSize, const RangeFunction& fn) {
+    if (count == 0) return;
+    if (chunkSize == 0) chunkSize = 1;
+
+    size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    if (workers.empty() || chunkCount == 1) {
+        for (size_t begin = 0; begin < count; begin += chunkSize) {
+            fn(begin, std::min(begin + chunkSize, count), 0);
+        }
+        return;
+    }
+
+    std::atomic<size_t> remaining{chunkCount};
+
+    // Count the jobs before they become visible, so a thief can never take the counter below zero
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        queuedJobs.fetch_add(chunkCount, std::memory_order_relaxed);
+    }
+
+    // Hand out contiguous runs of chunks so neighbouring data tends to stay on one thread
+    size_t threadCount = queues.size();
+    for (size_t t = 0; t < threadCount; ++t) {
+        size_t firstChunk = chunkCount * t / threadCount;
+        size_t lastChunk = chunkCount * (t + 1) / threadCount;
+        if (firstChunk == lastChunk) continue;
+
+        Queue& queue = *queues[t];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        // Pushed in reverse so the owner, which pops from the back, runs its chunks in order
+        for (size_t chunk = lastChunk; chunk-- > firstChunk;) {
+            size_t begin = chunk * chunkSize;
+            queue.jobs.push_back({&fn, begin, std::min(begin + chunkSize, count), &remaining});
+        }
+    }
+
+    wakeCondition.notify_all();
+
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!runOneJob(0)) {
+            std::this_thread::yield();
+        }
+    }
+}
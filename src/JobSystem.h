@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fork-join job system. Every thread has its own deque: the owner pops from the back and idle threads
+// steal from the front of the others. The thread calling parallelFor works as thread 0 until its jobs are done,
+// so parallelFor must only be called from the thread that owns the JobSystem.
+class JobSystem {
+public:
+    // fn(begin, end, threadIndex) with threadIndex in [0, getThreadCount())
+    using RangeFunction = std::function<void(size_t, size_t, unsigned)>;
+
+    // workerCount of 0 uses one worker per hardware thread, minus the calling thread
+    explicit JobSystem(unsigned workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    [[nodiscard]] unsigned getThreadCount() const { return static_cast<unsigned>(queues.size()); }
+
+    // Splits [0, count) into chunks of chunkSize and returns once every chunk has run
+    void parallelFor(size_t count, size_t chunkSize, const RangeFunction& fn);
+
+private:
+    struct Job {
+        const RangeFunction* fn;
+        size_t begin;
+        size_t end;
+        std::atomic<size_t>* remaining;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;  // Index 0 belongs to the calling thread
+    std::vector<std::thread> workers;
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<size_t> queuedJobs{0};
+    bool stopping = false;
+
+    bool runOneJob(unsigned threadIndex);
+    void workerLoop(unsigned threadIndex);
+};
@@ -0,0 +1,30 @@
+#include <algorithm>
+#include <cmath>
+#include "LocalNetplay.h"
+
+LocalNetplay::LocalNetplay(const MatchSettings& settings, const BeybladeConfig configs[2],
+                           const LaunchParameters launches[2], const RollbackSettings& rollback,
+                           uint32_t latencyFrames, float lossPercent)
+        : pipe(latencyFrames, lossPercent), clock(kFramesPerSecond) {
+    // Each netplay frame covers as many match steps as fit in a 60th of a second
+    RollbackSettings peerSettings = rollback;
+    peerSettings.stepsPerFrame = std::max(1u, static_cast<uint32_t>(std::lround(settings.stepsPerSecond / kFramesPerSecond)));
+
+    std::shared_ptr<const StaticGeometry> stadiumGeometry = createStadiumGeometry(settings);
+    for (int peer = 0; peer < 2; ++peer) {
+        matches[peer] = std::make_unique<Match>(settings, configs, launches, stadiumGeometry);
+        sessions[peer] = std::make_unique<RollbackSession>(*matches[peer], peer, pipe.endpoint(peer), peerSettings);
+    }
+}
+
+int LocalNetplay::advance(float frameTime, PlayerInput player1, PlayerInput player2) {
+    int frames = clock.advance(frameTime);
+    for (int i = 0; i < frames; ++i) {
+        sessions[0]->advanceFrame(player1);
+        sessions[1]->advanceFrame(player2);
+        pipe.tick();
+    }
+    // The previous state is only one match step back, not one frame, so there is nothing useful to blend
+    matches[0]->getWorld().interpolate(1.0f);
+    return frames;
+}
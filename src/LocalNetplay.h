@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "Match.h"
+#include "PhysicsClock.h"
+#include "RollbackSession.h"
+#include "Transport.h"
+
+// Two players on one machine, each with their own peer: a Match and a RollbackSession talking to the other peer
+// through a LoopbackPipe with simulated latency and loss. The game shows the first peer's match, so what is on
+// screen has gone through input delay, prediction and rollback just as it would over a real connection.
+class LocalNetplay {
+public:
+    static constexpr float kFramesPerSecond = 60.0f;
+
+    LocalNetplay(const MatchSettings& settings, const BeybladeConfig configs[2], const LaunchParameters launches[2],
+                 const RollbackSettings& rollback, uint32_t latencyFrames, float lossPercent);
+
+    // Runs the netplay frames owed after frameTime seconds, each peer reading its own player's input, and
+    // returns how many ran. Render transforms are left at the newest state.
+    int advance(float frameTime, PlayerInput player1, PlayerInput player2);
+
+    // The first peer's match; its tops are the ones to draw
+    [[nodiscard]] Match& getMatch() { return *matches[0]; }
+    [[nodiscard]] const RollbackSession& getSession(int peer) const { return *sessions[peer]; }
+
+private:
+    LoopbackPipe pipe;
+    PhysicsClock clock;
+    std::unique_ptr<Match> matches[2];
+    std::unique_ptr<RollbackSession> sessions[2];
+};
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include "Match.h"
+#include "StadiumGeometry.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+}
+
+const char* matchOutcomeName(MatchOutcome outcome) {
+    switch (outcome) {
+        case MatchOutcome::RingOut: return "ring-out";
+        case MatchOutcome::SpinOut: return "spin-out";
+        case MatchOutcome::Draw: return "draw";
+    }
+    return "unknown";
+}
+
+void randomLaunches(unsigned seed, const MatchSettings& settings, const BeybladeConfig configs[2],
+                    LaunchParameters launches[2]) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> angle(0.0f, 2.0f * static_cast<float>(M_PI));
+    std::uniform_real_distribution<float> distance(0.3f, 0.7f);
+    std::uniform_real_distribution<float> speed(0.5f, 2.0f);
+    std::uniform_real_distribution<float> spin(150.0f, 300.0f);
+
+    float theta = angle(rng);
+    for (int i = 0; i < 2; ++i) {
+        float a = theta + static_cast<float>(i) * static_cast<float>(M_PI);
+        float r = distance(rng) * settings.stadiumRadius;
+        glm::vec3 radial(std::cos(a), 0.0f, std::sin(a));
+        glm::vec3 tangent(-radial.z, 0.0f, radial.x);
+
+        launches[i].position = radial * r;
+        launches[i].position.y = settings.stadiumCurvature * r * r + configs[i].height;
+        launches[i].velocity = tangent * speed(rng);
+        launches[i].spin = spin(rng);
+    }
+}
+
+glm::vec2 PlayerInput::direction() const {
+    glm::vec2 steer(0.0f);
+    if (buttons & Left) steer.x -= 1.0f;
+    if (buttons & Right) steer.x += 1.0f;
+    if (buttons & Forward) steer.y -= 1.0f;
+    if (buttons & Back) steer.y += 1.0f;
+    // A constant rather than normalize, so diagonals come out the same on every peer
+    return steer.x != 0.0f && steer.y != 0.0f ? steer * 0.70710678f : steer;
+}
+
+std::shared_ptr<const StaticGeometry> createStadiumGeometry(const MatchSettings& settings) {
+    // Stadium sits at the origin. The analytic bowl only needs one box around it for the broadphase.
+    float radius = settings.stadiumRadius;
+    if (settings.analyticStadium) {
+        float rimHeight = settings.stadiumCurvature * radius * radius;
+        BoundingBox bounds(glm::vec3(-radius, -rimHeight, -radius), glm::vec3(radius, rimHeight, radius));
+        return StaticGeometry::create(glm::vec3(0.0f), {bounds}, false,
+                                      std::make_shared<StadiumCollider>(glm::vec3(0.0f), radius, settings.stadiumCurvature));
+    }
+    StadiumGeometry geometry;
+    geometry.generate(radius, settings.stadiumCurvature, settings.numRings, settings.verticesPerRing);
+    return geometry.createStaticGeometry(glm::vec3(0.0f));
+}
+
+Match::Match(const MatchSettings& settings, const BeybladeConfig configs_[2], const LaunchParameters launches[2],
+             std::shared_ptr<const StaticGeometry> stadiumGeometry)
+        : settings(settings) {
+    auto start = Clock::now();
+    world.gravity = glm::vec3(0.0f, -settings.gravity, 0.0f);
+    world.solverSettings = settings.solver;
+
+    float radius = settings.stadiumRadius;
+    float rimHeight = settings.stadiumCurvature * radius * radius;
+    stadium = world.createImmovableBody(glm::vec3(0.0f), glm::vec3(radius * 2.0f, rimHeight, radius * 2.0f));
+    world.getBody(stadium)->setStaticGeometry(stadiumGeometry ? std::move(stadiumGeometry) : createStadiumGeometry(settings));
+
+    reset(configs_, launches);
+    result.setupSeconds = secondsSince(start);
+}
+
+void Match::reset(const BeybladeConfig configs_[2], const LaunchParameters launches[2]) {
+    auto start = Clock::now();
+
+    // Last one first, so the pool hands the slots back in the order the tops first got them
+    world.destroyBody(tops[1]);
+    world.destroyBody(tops[0]);
+    for (int i = 0; i < 2; ++i) {
+        configs[i] = configs_[i];
+        const BeybladeConfig& config = configs[i];
+        glm::vec3 half(config.radius, config.height * 0.5f, config.radius);
+        tops[i] = world.createBody(launches[i].position, half * 2.0f, config.mass);
+        RigidBody* top = world.getBody(tops[i]);
+        top->localBoxes.emplace_back(-half, half);
+        top->updateBoundingBoxes();
+        top->velocity = launches[i].velocity;
+        top->angularVelocity = glm::vec3(0.0f, launches[i].spin, 0.0f);
+        top->spinFriction = config.spinDecay;
+        top->friction = config.friction;
+        top->shape = {ShapeType::Disc, config.radius};
+        top->continuousCollision = true;
+    }
+
+    inputs[0] = inputs[1] = PlayerInput{};
+    world.snapshot(startState);
+    result = MatchResult{};
+    finished = false;
+    recorder = nullptr;
+    result.setupSeconds = secondsSince(start);
+}
+
+void Match::restart() {
+    auto start = Clock::now();
+    world.restore(startState);
+    inputs[0] = inputs[1] = PlayerInput{};
+    result = MatchResult{};
+    finished = false;
+    recorder = nullptr;
+    result.setupSeconds = secondsSince(start);
+}
+
+void Match::snapshot(MatchSnapshot& snapshot) const {
+    world.snapshot(snapshot.world);
+    snapshot.result = result;
+    snapshot.inputs[0] = inputs[0];
+    snapshot.inputs[1] = inputs[1];
+    snapshot.finished = finished;
+}
+
+bool Match::restore(const MatchSnapshot& snapshot) {
+    if (!world.restore(snapshot.world)) return false;
+    result = snapshot.result;
+    inputs[0] = snapshot.inputs[0];
+    inputs[1] = snapshot.inputs[1];
+    finished = snapshot.finished;
+    return true;
+}
+
+void Match::setRecorder(ReplayRecorder* replayRecorder) {
+    recorder = replayRecorder;
+    if (recorder) {
+        recorder->begin(world, settings.stepsPerSecond);
+    }
+}
+
+bool Match::step() {
+    if (finished) return false;
+
+    float dt = 1.0f / settings.stepsPerSecond;
+    // Steering changes velocities before the step, so a recorder sees it like any other outside push
+    for (int i = 0; i < 2; ++i) {
+        glm::vec2 steer = inputs[i].direction();
+        if (steer != glm::vec2(0.0f)) {
+            world.getBody(tops[i])->velocity += glm::vec3(steer.x, 0.0f, steer.y) * (settings.steerAcceleration * dt);
+        }
+    }
+    if (recorder) recorder->captureInputs(world);
+    auto start = Clock::now();
+    world.update(dt);
+    double elapsed = secondsSince(start);
+    if (recorder) recorder->endStep(world);
+    result.stepSeconds += elapsed;
+    result.maxStepSeconds = std::max(result.maxStepSeconds, elapsed);
+    const SolverStats& solverStats = world.getSolverStats();
+    result.solverSeconds += solverStats.seconds;
+    if (solverStats.rows > 0) {
+        result.residualSum += solverStats.residual;
+        result.solvedSteps++;
+        result.maxResidual = std::max(result.maxResidual, solverStats.residual);
+    }
+    result.steps++;
+    result.simulatedSeconds = static_cast<float>(result.steps) * dt;
+
+    const RigidBody& top0 = *world.getBody(tops[0]);
+    const RigidBody& top1 = *world.getBody(tops[1]);
+    bool ringOut0 = isRingOut(top0);
+    bool ringOut1 = isRingOut(top1);
+    if (ringOut0 || ringOut1) {
+        finish(ringOut0, ringOut1, MatchOutcome::RingOut);
+        return false;
+    }
+
+    bool spinOut0 = glm::length(top0.angularVelocity) < settings.minSpin;
+    bool spinOut1 = glm::length(top1.angularVelocity) < settings.minSpin;
+    if (spinOut0 || spinOut1) {
+        finish(spinOut0, spinOut1, MatchOutcome::SpinOut);
+        return false;
+    }
+
+    if (result.simulatedSeconds >= settings.maxDuration) {
+        finish(true, true, MatchOutcome::Draw);
+        return false;
+    }
+    return true;
+}
+
+MatchResult Match::run() {
+    while (step()) {}
+    return result;
+}
+
+bool Match::isRingOut(const RigidBody& top) const {
+    float r = glm::length(glm::vec2(top.position.x, top.position.z));
+    if (r > settings.stadiumRadius) return true;
+
+    // Sunk more than its own height below the bowl surface
+    float floorHeight = settings.stadiumCurvature * r * r;
+    return top.position.y < floorHeight - top.aggregateBoundingBox.max.y + top.aggregateBoundingBox.min.y;
+}
+
+void Match::finish(bool out0, bool out1, MatchOutcome outcome) {
+    finished = true;
+    if (out0 && out1) {
+        result.winner = -1;
+        result.outcome = MatchOutcome::Draw;
+    } else {
+        result.winner = out0 ? 1 : 0;
+        result.outcome = outcome;
+    }
+}
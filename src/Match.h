@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "PhysicsWorld.h"
+#include "RigidBody.h"
+#include "Replay.h"
+
+// A single two-top battle on the stadium, run entirely on the CPU with no window or GL context.
+// Used by the headless simulator; the game builds its own world around the rendered objects.
+
+struct BeybladeConfig {
+    std::string name = "Beyblade";
+    float mass = 1.0f;
+    float radius = 0.3f;
+    float height = 0.2f;
+    float spinDecay = 20.0f;  // Spin lost to tip friction, in rad/s per second
+    float friction = 0.05f;   // Sliding friction of the tip against the stadium and the other top
+};
+
+struct LaunchParameters {
+    glm::vec3 position{0.0f};
+    glm::vec3 velocity{0.0f};
+    float spin = 200.0f;  // rad/s about the world up axis
+};
+
+struct MatchSettings {
+    float stepsPerSecond = 240.0f;
+    float maxDuration = 60.0f;  // Simulated seconds before the match is called a draw
+    float gravity = 9.81f;
+    float minSpin = 5.0f;       // A top spinning slower than this has spun out
+    float stadiumRadius = 4.0f;
+    float stadiumCurvature = 0.02f;
+    bool analyticStadium = true;  // Exact bowl collider; false collides against the per-triangle boxes instead
+    int numRings = 10;            // Mesh resolution, only used without the analytic collider
+    int verticesPerRing = 64;
+    float steerAcceleration = 2.0f;  // m/s^2 a held steer input pushes a top with, along the bowl's floor
+    SolverSettings solver;
+};
+
+// What one player holds down during a step: steer directions along the world x and z axes
+struct PlayerInput {
+    enum Bits : uint8_t {
+        Left = 1,     // -x
+        Right = 2,    // +x
+        Forward = 4,  // -z
+        Back = 8      // +z
+    };
+
+    uint8_t buttons = 0;
+
+    // Unit steer direction in the x-z plane, zero when nothing or only opposing directions are held
+    [[nodiscard]] glm::vec2 direction() const;
+    bool operator==(const PlayerInput& other) const { return buttons == other.buttons; }
+    bool operator!=(const PlayerInput& other) const { return buttons != other.buttons; }
+};
+
+enum class MatchOutcome {
+    RingOut,  // The loser left the stadium or fell through its floor
+    SpinOut,  // The loser stopped spinning
+    Draw      // Both tops went out on the same step, or time ran out
+};
+
+struct MatchResult {
+    int winner = -1;  // 0 or 1, -1 for a draw
+    MatchOutcome outcome = MatchOutcome::Draw;
+    int steps = 0;
+    float simulatedSeconds = 0.0f;
+    double setupSeconds = 0.0f;     // Wall time spent building the stadium and bodies
+    double stepSeconds = 0.0f;      // Wall time spent in PhysicsWorld::update
+    double maxStepSeconds = 0.0f;   // Slowest single step
+    double solverSeconds = 0.0;     // Part of stepSeconds spent in the contact solver
+    double residualSum = 0.0;       // Summed over steps that had contacts
+    int solvedSteps = 0;            // Steps that had contacts
+    float maxResidual = 0.0f;
+};
+
+const char* matchOutcomeName(MatchOutcome outcome);
+
+// Both tops start on opposite sides of the bowl, sliding around it in the same direction. Launches depend only on
+// the seed, so results do not depend on which thread ran a match.
+void randomLaunches(unsigned seed, const MatchSettings& settings, const BeybladeConfig configs[2],
+                    LaunchParameters launches[2]);
+
+// The stadium's collision geometry for settings. Matches built with the same settings can all share one copy,
+// whichever threads they run on.
+std::shared_ptr<const StaticGeometry> createStadiumGeometry(const MatchSettings& settings);
+
+// Everything a Match needs to carry on from a step: its world and its own progress
+struct MatchSnapshot {
+    PhysicsSnapshot world;
+    MatchResult result;
+    PlayerInput inputs[2];
+    bool finished = false;
+};
+
+class Match {
+public:
+    // Without a stadium the match builds its own from settings. A shared one must come from
+    // createStadiumGeometry with the same stadium settings.
+    Match(const MatchSettings& settings, const BeybladeConfig configs[2], const LaunchParameters launches[2],
+          std::shared_ptr<const StaticGeometry> stadiumGeometry = nullptr);
+
+    // Starts a new match on the same stadium. Only the tops are recreated, in slots the world already has, and
+    // the match plays out exactly as it would in a newly constructed Match.
+    void reset(const BeybladeConfig configs[2], const LaunchParameters launches[2]);
+
+    // Plays the same match again from its first step. The world is restored from the snapshot reset took, so
+    // nothing is created or destroyed, and the rerun is identical to the first run.
+    void restart();
+
+    // Held by the player controlling top index until changed
+    void setInput(int index, PlayerInput input) { inputs[index] = input; }
+
+    // For rollback and lookahead: the match carries on from a restored snapshot exactly as it did from the
+    // state the snapshot was taken in. restore fails if tops were recreated by reset since.
+    void snapshot(MatchSnapshot& snapshot) const;
+    bool restore(const MatchSnapshot& snapshot);
+
+    // Advances one fixed step and returns false once the match is decided
+    bool step();
+    // Steps until the match is decided and returns the result
+    MatchResult run();
+
+    // Records the match from its current state onwards. The recorder must outlive the match.
+    void setRecorder(ReplayRecorder* replayRecorder);
+
+    [[nodiscard]] const MatchResult& getResult() const { return result; }
+    [[nodiscard]] PhysicsWorld& getWorld() { return world; }
+    [[nodiscard]] RigidBody* getTop(int index) const { return world.getBody(tops[index]); }
+
+private:
+    MatchSettings settings;
+    BeybladeConfig configs[2];
+    PhysicsWorld world;
+    BodyHandle stadium;
+    BodyHandle tops[2];
+    MatchResult result;
+    PhysicsSnapshot startState;  // Taken by reset, for restart
+    PlayerInput inputs[2];
+    ReplayRecorder* recorder = nullptr;
+    bool finished = false;
+
+    [[nodiscard]] bool isRingOut(const RigidBody& top) const;
+    void finish(bool out0, bool out1, MatchOutcome outcome);
+};
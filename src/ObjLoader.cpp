@@ -0,0 +1,95 @@
+#include <iostream>
+#include "ObjLoader.h"
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+bool loadObjMesh(const std::string& path, ObjMesh& mesh, bool verbose) {
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+
+    // Extract directory from the path
+    std::string baseDir = path.substr(0, path.find_last_of("/\\"));
+    if (baseDir.empty()) {
+        baseDir = ".";
+    }
+
+    bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str(), baseDir.c_str(), true, true);
+
+    if (!warn.empty() && verbose) {
+        std::cout << "WARN::TINYOBJLOADER::" << warn << std::endl;
+    }
+
+    if (!err.empty()) {
+        std::cerr << "ERROR::TINYOBJLOADER::" << err << std::endl;
+    }
+
+    if (!ret) {
+        std::cerr << "ERROR::TINYOBJLOADER::Failed to load/parse .obj.\n";
+        return false;
+    }
+
+    mesh.vertices.clear();
+    mesh.normals.clear();
+    mesh.texCoords.clear();
+    mesh.colors.clear();
+    mesh.indices.clear();
+    mesh.materialColors.clear();
+
+    // Attribute arrays are indexed directly; a missing index (-1) or one past the end reads as zero
+    auto vertexCount = static_cast<int>(attrib.vertices.size() / 3);
+    auto normalCount = static_cast<int>(attrib.normals.size() / 3);
+    auto texCoordCount = static_cast<int>(attrib.texcoords.size() / 2);
+
+    std::vector<glm::vec3> materialDiffuse(materials.size());
+    for (size_t i = 0; i < materials.size(); ++i) {
+        const auto& material = materials[i];
+        materialDiffuse[i] = glm::vec3(material.diffuse[0], material.diffuse[1], material.diffuse[2]);
+        mesh.materialColors[material.name] = materialDiffuse[i];
+
+        if (verbose) {
+            std::cout << "Material name: " << material.name << std::endl;
+            std::cout << "Diffuse: " << materialDiffuse[i].x << ", " << materialDiffuse[i].y << ", "
+                      << materialDiffuse[i].z << std::endl;
+        }
+    }
+
+    size_t cornerCount = 0;
+    for (const auto& shape : shapes) {
+        cornerCount += shape.mesh.indices.size();
+    }
+    mesh.vertices.reserve(cornerCount);
+    mesh.normals.reserve(cornerCount);
+    mesh.texCoords.reserve(cornerCount);
+    mesh.colors.reserve(cornerCount);
+    mesh.indices.reserve(cornerCount);
+
+    for (const auto& shape : shapes) {
+        for (size_t faceIndex = 0; faceIndex < shape.mesh.indices.size() / 3; ++faceIndex) {
+            int materialIndex = shape.mesh.material_ids[faceIndex];
+            glm::vec3 color = materialIndex >= 0 && materialIndex < static_cast<int>(materialDiffuse.size())
+                              ? materialDiffuse[materialIndex] : glm::vec3(1.0f);
+
+            for (size_t corner = 0; corner < 3; ++corner) {
+                const tinyobj::index_t& index = shape.mesh.indices[3 * faceIndex + corner];
+                int v = index.vertex_index;
+                int n = index.normal_index;
+                int t = index.texcoord_index;
+
+                mesh.vertices.push_back(v >= 0 && v < vertexCount
+                    ? glm::vec3(attrib.vertices[3 * v], attrib.vertices[3 * v + 1], attrib.vertices[3 * v + 2])
+                    : glm::vec3(0.0f));
+                mesh.normals.push_back(n >= 0 && n < normalCount
+                    ? glm::vec3(attrib.normals[3 * n], attrib.normals[3 * n + 1], attrib.normals[3 * n + 2])
+                    : glm::vec3(0.0f));
+                mesh.texCoords.push_back(t >= 0 && t < texCoordCount
+                    ? glm::vec2(attrib.texcoords[2 * t], attrib.texcoords[2 * t + 1])
+                    : glm::vec2(0.0f));
+                mesh.indices.push_back(static_cast<unsigned int>(mesh.indices.size()));
+                mesh.colors.push_back(color);
+            }
+        }
+    }
+    return true;
+}
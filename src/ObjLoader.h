@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+// An OBJ model flattened to one vertex per triangle corner, in the layout the renderer uploads. Loading needs
+// no GL context, so tools and benchmarks can use it too.
+struct ObjMesh {
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec3> normals;     // Zero where the file has none
+    std::vector<glm::vec2> texCoords;   // Zero where the file has none
+    std::vector<glm::vec3> colors;      // Diffuse color of each corner's material, white without one
+    std::vector<unsigned int> indices;  // Three per triangle
+    std::unordered_map<std::string, glm::vec3> materialColors;  // Diffuse color by material name
+};
+
+// Loads and triangulates path, with materials looked up next to it. Errors always go to the console, warnings
+// and the material list only when verbose. Returns false, leaving mesh untouched, if the file cannot be parsed.
+bool loadObjMesh(const std::string& path, ObjMesh& mesh, bool verbose = true);
@@ -0,0 +1,21 @@
+#include <cmath>
+#include "PhysicsClock.h"
+
+PhysicsClock::PhysicsClock(float stepsPerSecond, int maxSubsteps)
+        : step(1.0f / stepsPerSecond), maxSubsteps(maxSubsteps) {}
+
+int PhysicsClock::advance(float frameTime) {
+    if (frameTime > 0.0f) {
+        accumulator += frameTime;
+    }
+
+    auto steps = static_cast<int>(std::floor(accumulator / step));
+    if (steps > maxSubsteps) {
+        droppedSteps += steps - maxSubsteps;
+        steps = maxSubsteps;
+        accumulator = std::fmod(accumulator, step) + steps * step;
+    }
+    accumulator -= static_cast<float>(steps) * step;
+    if (accumulator < 0.0f) accumulator = 0.0f;
+    return steps;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Fixed-rate simulation clock. Frame time goes into an accumulator that is drained in whole steps, so physics
+// results do not depend on the frame rate. getAlpha() is how far the clock is into the next step and is used
+// to interpolate render transforms between the last two physics states.
+class PhysicsClock {
+public:
+    explicit PhysicsClock(float stepsPerSecond = 240.0f, int maxSubsteps = 8);
+
+    // Adds the frame time and returns the number of fixed steps to run this frame. When more than maxSubsteps
+    // are owed, the extra time is dropped so a slow frame cannot cause an ever-growing backlog.
+    int advance(float frameTime);
+
+    [[nodiscard]] float getStep() const { return step; }
+    [[nodiscard]] float getAlpha() const { return accumulator / step; }
+    [[nodiscard]] int getDroppedSteps() const { return droppedSteps; }
+
+private:
+    float step;
+    float accumulator = 0.0f;
+    int maxSubsteps;
+    int droppedSteps = 0;  // Total steps discarded so far by the substep cap
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Where one PhysicsWorld::update spent its time, and how much work each phase had
+struct PhysicsStepStats {
+    double integrateSeconds = 0.0;    // Forces, integration and the continuous collision sweep
+    double broadphaseSeconds = 0.0;
+    double narrowphaseSeconds = 0.0;  // Box and stadium contacts, waking touched bodies and building manifolds
+    double solveSeconds = 0.0;
+    double sleepSeconds = 0.0;        // Island building and putting islands to sleep
+    double totalSeconds = 0.0;
+
+    uint32_t bodies = 0;
+    uint32_t pairs = 0;       // Candidate pairs from the broadphase
+    uint32_t contacts = 0;    // Contact points found, swept ones included
+    uint32_t manifolds = 0;
+    uint32_t sleeping = 0;    // Movable bodies asleep after the step
+};
+
+// The most recent steps in a fixed ring, so recording never allocates. Indexing is oldest first.
+class PhysicsStatsHistory {
+public:
+    static constexpr size_t kCapacity = 240;
+
+    void push(const PhysicsStepStats& stats) {
+        steps[next] = stats;
+        next = (next + 1) % kCapacity;
+        if (count < kCapacity) ++count;
+    }
+    void clear() {
+        next = 0;
+        count = 0;
+    }
+
+    [[nodiscard]] size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+    [[nodiscard]] const PhysicsStepStats& operator[](size_t i) const {
+        return steps[(next + kCapacity - count + i) % kCapacity];
+    }
+    [[nodiscard]] const PhysicsStepStats& latest() const { return (*this)[count - 1]; }
+
+private:
+    std::array<PhysicsStepStats, kCapacity> steps{};
+    size_t next = 0;
+    size_t count = 0;
+};
@@ -1,67 +1,759 @@
-#include <iostream>
 #include "PhysicsWorld.h"
+#include "SweepAndPrune.h"
+#include "UniformGrid.h"
+#include "JobSystem.h"
+#include "ContinuousCollision.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
 
-void PhysicsWorld::addBody(RigidBody* body) {
+namespace {
+    // Fixed chunk sizes keep the contact order independent of how many threads run the chunks
+    constexpr size_t kIntegrateChunkSize = 64;
+    constexpr size_t kPairChunkSize = 16;
+
+    // Bodies moving less than this fraction of their radius in a step cannot skip past anything
+    constexpr float kSweepMotionFraction = 0.5f;
+    constexpr float kSweepTolerance = 0.001f;
+
+    bool isAwake(const RigidBody* body) {
+        return body->mass < FLT_MAX && !body->sleeping;
+    }
+
+    // Whether any of the body's collision boxes overlaps bounds, not just its aggregate bounds
+    bool anyBoxOverlaps(const RigidBody* body, const BoundingBox& bounds) {
+        if (!body->aggregateBoundingBox.checkCollision(bounds)) return false;
+        if (const BVH* tree = body->getBoxTree()) {
+            return tree->anyOverlap(bounds.min, bounds.max, [](uint32_t) { return true; });
+        }
+        for (const BoundingBox& box : body->getCollisionBoxes()) {
+            if (box.checkCollision(bounds)) return true;
+        }
+        return false;
+    }
+
+    bool anyBoxInSphere(const RigidBody* body, const glm::vec3& center, float radius) {
+        if (!body->aggregateBoundingBox.intersectsSphere(center, radius)) return false;
+        const std::vector<BoundingBox>& boxes = body->getCollisionBoxes();
+        if (const BVH* tree = body->getBoxTree()) {
+            return tree->anyOverlap(center - radius, center + radius, [&](uint32_t index) {
+                return boxes[index].intersectsSphere(center, radius);
+            });
+        }
+        for (const BoundingBox& box : boxes) {
+            if (box.intersectsSphere(center, radius)) return true;
+        }
+        return false;
+    }
+
+    struct SnapshotHeader {
+        uint32_t bodyCount;
+        uint32_t manifoldCount;
+        uint64_t awakeCount;
+    };
+
+    // One body in a PhysicsSnapshot, followed in the buffer by its boxCount world-space boxes
+    struct BodySnapshotKey {
+        uint32_t id;
+        uint32_t generation;
+        uint32_t boxCount;
+    };
+    struct BodySnapshot {
+        BodySnapshotKey key;  // First, so restore can check the bodies match without copying the rest
+        glm::vec3 position;
+        glm::vec3 velocity;
+        glm::vec3 acceleration;
+        glm::vec3 force;
+        glm::vec3 angularVelocity;
+        glm::vec3 torque;
+        glm::quat orientation;
+        glm::vec3 previousPosition;
+        glm::quat previousOrientation;
+        glm::vec3 renderPosition;
+        glm::quat renderOrientation;
+        glm::mat3 inertiaTensor;
+        glm::mat3 inverseInertiaLocal;
+        glm::mat3 inverseInertiaTensor;
+        float mass;
+        float friction;
+        float spinFriction;
+        CollisionShape shape;
+        BoundingBox aggregateBoundingBox;
+        float sleepTimer;
+        uint32_t sleepIsland;
+        bool continuousCollision;
+        bool sleeping;
+    };
+    static_assert(std::is_trivially_copyable<BodySnapshot>::value, "snapshots are copied with memcpy");
+    static_assert(std::is_trivially_copyable<BoundingBox>::value, "snapshots are copied with memcpy");
+    static_assert(std::is_trivially_copyable<ContactManifold>::value, "snapshots are copied with memcpy");
+
+    // Static geometry is shared and never moves, so only bodies with their own boxes store any
+    size_t snapshotBoxCount(const RigidBody* body) {
+        return body->staticGeometry ? 0 : body->boundingBoxes.size();
+    }
+
+    // Sleeping bodies keep zero velocity and their previous state equal to the current one, so anything else
+    // means a caller launched, moved or pushed the body since it fell asleep
+    bool isDisturbed(const RigidBody* body) {
+        return body->velocity != glm::vec3(0.0f) || body->angularVelocity != glm::vec3(0.0f) ||
+               body->force != glm::vec3(0.0f) || body->torque != glm::vec3(0.0f) ||
+               body->position != body->previousPosition || body->orientation != body->previousOrientation;
+    }
+}
+
+PhysicsWorld::PhysicsWorld() {
+    setBroadphase(BroadphaseType::SweepAndPrune);
+}
+
+BodyHandle PhysicsWorld::createBody(const glm::vec3& position, const glm::vec3& size, float mass) {
+    BodyHandle handle = bodyPool.allocate();
+    RigidBody* body = bodyPool.get(handle);
+    body->reset(position, size, mass);
+    body->id = handle.index;
+
+    if (bodyIndices.size() < bodyPool.slotCount()) {
+        bodyIndices.resize(bodyPool.slotCount());
+    }
+    bodyIndices[handle.index] = static_cast<uint32_t>(bodies.size());
     bodies.push_back(body);
+    broadphase->addBody(body);
+    queryTreeInvalid = true;
+    return handle;
 }
 
-void PhysicsWorld::update(float deltaTime) {
-    // Update all bodies
+BodyHandle PhysicsWorld::createImmovableBody(const glm::vec3& position, const glm::vec3& size) {
+    return createBody(position, size, FLT_MAX);
+}
+
+void PhysicsWorld::destroyBody(BodyHandle handle) {
+    RigidBody* body = bodyPool.get(handle);
+    if (!body) return;
+
+    broadphase->removeBody(body);
+    contactCache.removeBody(body);
+
+    // Swap the last body into the hole
+    uint32_t index = bodyIndices[body->id];
+    bodies[index] = bodies.back();
+    bodyIndices[bodies[index]->id] = index;
+    bodies.pop_back();
+    queryTreeInvalid = true;
+
+    // Let go of anything shared now rather than when the slot is reused
+    body->staticGeometry.reset();
+    bodyPool.release(handle);
+}
+
+void PhysicsWorld::clear() {
     for (RigidBody* body : bodies) {
-        body->update(deltaTime);
+        body->staticGeometry.reset();
+    }
+    bodies.clear();
+    bodyPool.clear();
+    broadphase->clear();
+    contactCache.clear();
+    contacts.clear();
+    sweptContacts.clear();
+    awakeCount = 0;
+    stepStats = {};
+    statsHistory.clear();
+    queryTreeInvalid = true;
+}
+
+void PhysicsWorld::snapshot(PhysicsSnapshot& snapshot) const {
+    const std::vector<ContactManifold>& manifolds = contactCache.getManifolds();
+    size_t size = sizeof(SnapshotHeader) + bodies.size() * sizeof(BodySnapshot) +
+                  manifolds.size() * sizeof(ContactManifold);
+    for (const RigidBody* body : bodies) {
+        size += snapshotBoxCount(body) * sizeof(BoundingBox);
+    }
+    if (snapshot.buffer.size() < size) {
+        snapshot.buffer.resize(size);
     }
+    snapshot.size = size;
+    snapshot.world = this;
+
+    uint8_t* out = snapshot.buffer.data();
+    SnapshotHeader header{static_cast<uint32_t>(bodies.size()), static_cast<uint32_t>(manifolds.size()), awakeCount};
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    for (const RigidBody* body : bodies) {
+        BodySnapshot state{};
+        state.key = {body->id, getHandle(body).generation, static_cast<uint32_t>(snapshotBoxCount(body))};
+        state.position = body->position;
+        state.velocity = body->velocity;
+        state.acceleration = body->acceleration;
+        state.force = body->force;
+        state.angularVelocity = body->angularVelocity;
+        state.torque = body->torque;
+        state.orientation = body->orientation;
+        state.previousPosition = body->previousPosition;
+        state.previousOrientation = body->previousOrientation;
+        state.renderPosition = body->renderPosition;
+        state.renderOrientation = body->renderOrientation;
+        state.inertiaTensor = body->inertiaTensor;
+        state.inverseInertiaLocal = body->inverseInertiaLocal;
+        state.inverseInertiaTensor = body->inverseInertiaTensor;
+        state.mass = body->mass;
+        state.friction = body->friction;
+        state.spinFriction = body->spinFriction;
+        state.shape = body->shape;
+        state.aggregateBoundingBox = body->aggregateBoundingBox;
+        state.sleepTimer = body->sleepTimer;
+        state.sleepIsland = body->sleepIsland;
+        state.continuousCollision = body->continuousCollision;
+        state.sleeping = body->sleeping;
+        std::memcpy(out, &state, sizeof(state));
+        out += sizeof(state);
+        std::memcpy(out, body->boundingBoxes.data(), state.key.boxCount * sizeof(BoundingBox));
+        out += state.key.boxCount * sizeof(BoundingBox);
+    }
+    std::memcpy(out, manifolds.data(), manifolds.size() * sizeof(ContactManifold));
+}
+
+bool PhysicsWorld::restore(const PhysicsSnapshot& snapshot) {
+    if (snapshot.world != this || snapshot.size == 0) return false;
+    const uint8_t* data = snapshot.buffer.data();
+    SnapshotHeader header{};
+    std::memcpy(&header, data, sizeof(header));
+    if (header.bodyCount != bodies.size()) return false;
 
-    // Detect and resolve collisions
+    // Check every body before touching any, so a stale snapshot leaves the world as it was
+    size_t offset = sizeof(header);
+    for (const RigidBody* body : bodies) {
+        BodySnapshotKey key{};
+        std::memcpy(&key, data + offset, sizeof(key));
+        if (key.id != body->id || key.generation != getHandle(body).generation ||
+            key.boxCount != snapshotBoxCount(body)) {
+            return false;
+        }
+        offset += sizeof(BodySnapshot) + key.boxCount * sizeof(BoundingBox);
+    }
+
+    const uint8_t* in = data + sizeof(header);
+    for (RigidBody* body : bodies) {
+        BodySnapshot state;
+        std::memcpy(&state, in, sizeof(state));
+        in += sizeof(state);
+        body->position = state.position;
+        body->velocity = state.velocity;
+        body->acceleration = state.acceleration;
+        body->force = state.force;
+        body->angularVelocity = state.angularVelocity;
+        body->torque = state.torque;
+        body->orientation = state.orientation;
+        body->previousPosition = state.previousPosition;
+        body->previousOrientation = state.previousOrientation;
+        body->renderPosition = state.renderPosition;
+        body->renderOrientation = state.renderOrientation;
+        body->inertiaTensor = state.inertiaTensor;
+        body->inverseInertiaLocal = state.inverseInertiaLocal;
+        body->inverseInertiaTensor = state.inverseInertiaTensor;
+        body->mass = state.mass;
+        body->friction = state.friction;
+        body->spinFriction = state.spinFriction;
+        body->shape = state.shape;
+        body->aggregateBoundingBox = state.aggregateBoundingBox;
+        body->sleepTimer = state.sleepTimer;
+        body->sleepIsland = state.sleepIsland;
+        body->continuousCollision = state.continuousCollision;
+        body->sleeping = state.sleeping;
+        if (state.key.boxCount > 0) {
+            std::memcpy(body->boundingBoxes.data(), in, state.key.boxCount * sizeof(BoundingBox));
+            body->boxSet.assign(body->boundingBoxes);
+        }
+        in += state.key.boxCount * sizeof(BoundingBox);
+    }
+
+    std::vector<ContactManifold>& manifolds = contactCache.getManifolds();
+    manifolds.resize(header.manifoldCount);
+    std::memcpy(manifolds.data(), in, header.manifoldCount * sizeof(ContactManifold));
+
+    // Last step's contacts belong to the state being left behind
+    contacts.clear();
+    sweptContacts.clear();
+    awakeCount = static_cast<size_t>(header.awakeCount);
+    queryTreeStale = true;
+    return true;
+}
+
+void PhysicsWorld::setBroadphase(BroadphaseType type) {
+    switch (type) {
+        case BroadphaseType::BruteForce:
+            broadphase = std::make_unique<BruteForceBroadphase>();
+            break;
+        case BroadphaseType::SweepAndPrune:
+            broadphase = std::make_unique<SweepAndPrune>();
+            break;
+        case BroadphaseType::UniformGrid:
+            broadphase = std::make_unique<UniformGrid>();
+            break;
+        default:
+            // Not a broadphase this build knows, keep the current one and its proxies
+            return;
+    }
+    broadphaseType = type;
+
+    // The new broadphase starts empty, so hand it every body already in the world
+    for (RigidBody* body : bodies) {
+        broadphase->addBody(body);
+    }
+}
+
+void PhysicsWorld::update(float deltaTime) {
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double>(to - from).count();
+    };
+
+    auto start = Clock::now();
+    integrateBodies(deltaTime);
+    sweepFastBodies();
+    auto integrated = Clock::now();
+
+    // Detect collisions, then solve them on this thread in a fixed order
+    broadphase->update();
+    auto broadphaseDone = Clock::now();
     detectCollisions();
+    size_t sweptBegin = contacts.size();
+    contacts.insert(contacts.end(), sweptContacts.begin(), sweptContacts.end());
+    wakeTouchedBodies();
+    buildManifolds(sweptBegin);
+    auto narrowphaseDone = Clock::now();
+    solver.solve(contactCache.getManifolds(), solverSettings);
+    auto solved = Clock::now();
+    updateSleep(deltaTime);
+    auto end = Clock::now();
+    queryTreeStale = true;
+
+    stepStats.integrateSeconds = seconds(start, integrated);
+    stepStats.broadphaseSeconds = seconds(integrated, broadphaseDone);
+    stepStats.narrowphaseSeconds = seconds(broadphaseDone, narrowphaseDone);
+    stepStats.solveSeconds = seconds(narrowphaseDone, solved);
+    stepStats.sleepSeconds = seconds(solved, end);
+    stepStats.totalSeconds = seconds(start, end);
+    stepStats.bodies = static_cast<uint32_t>(bodies.size());
+    stepStats.pairs = static_cast<uint32_t>(broadphase->getPairs().size());
+    stepStats.contacts = static_cast<uint32_t>(contacts.size());
+    stepStats.manifolds = static_cast<uint32_t>(contactCache.getManifolds().size());
+    stepStats.sleeping = 0;
+    for (const RigidBody* body : bodies) {
+        if (body->sleeping) stepStats.sleeping++;
+    }
+    statsHistory.push(stepStats);
 }
 
-void PhysicsWorld::detectCollisions() {
+void PhysicsWorld::interpolate(float alpha) {
+    for (RigidBody* body : bodies) {
+        body->interpolate(alpha);
+    }
+}
+
+void PhysicsWorld::runChunks(size_t count, size_t chunkSize, const std::function<void(size_t, size_t, unsigned)>& fn) {
+    if (jobSystem) {
+        jobSystem->parallelFor(count, chunkSize, fn);
+        return;
+    }
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        fn(begin, std::min(begin + chunkSize, count), 0);
+    }
+}
+
+void PhysicsWorld::integrateBodies(float deltaTime) {
+    // Bodies only touch their own state while integrating, so chunks can run on any thread
+    runChunks(bodies.size(), kIntegrateChunkSize, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            RigidBody* body = bodies[i];
+            if (body->sleeping) {
+                if (!isDisturbed(body)) continue;
+                body->sleeping = false;
+                body->sleepTimer = 0.0f;
+            }
+            if (body->mass < FLT_MAX) {
+                body->applyForce(gravity * body->mass);
+            }
+            body->update(deltaTime);
+        }
+    });
+}
+
+void PhysicsWorld::sweepFastBodies() {
+    sweptContacts.clear();
+    fastBodies.clear();
+    for (RigidBody* body : bodies) {
+        if (!body->continuousCollision || body->sleeping) continue;
+        glm::vec3 motion = body->position - body->previousPosition;
+        if (glm::length(motion) >= kSweepMotionFraction * sweepRadius(*body)) fastBodies.push_back(body);
+    }
+    if (fastBodies.empty()) return;
+
+    // Fit the query tree around where each body was over the whole step, so a fast body's candidates are the
+    // ones whose own paths reach into its swept bounds. The next query puts the tree back on the current bounds.
+    auto pathBounds = [](const RigidBody& other) {
+        BoundingBox bounds = other.aggregateBoundingBox;
+        if (other.mass < FLT_MAX) {
+            bounds.expandToInclude(bounds.min - (other.position - other.previousPosition));
+            bounds.expandToInclude(bounds.max - (other.position - other.previousPosition));
+        }
+        return bounds;
+    };
+    queryBounds.resize(bodies.size());
     for (size_t i = 0; i < bodies.size(); ++i) {
-        for (size_t j = i + 1; j < bodies.size(); ++j) {
-            RigidBody* bodyA = bodies[i];
-            RigidBody* bodyB = bodies[j];
-
-            for (const auto& boxA : bodyA->boundingBoxes) {
-                for (const auto& boxB : bodyB->boundingBoxes) {
-                    if (boxA->checkCollision(*boxB)) {
-                        resolveCollision(bodyA, bodyB);
-                    }
-                }
+        queryBounds[i] = pathBounds(*bodies[i]);
+    }
+    if (queryTreeInvalid) {
+        queryTree.build(queryBounds);
+    } else {
+        queryTree.refit(queryBounds);
+    }
+    queryTreeInvalid = false;
+    queryTreeStale = true;
+
+    for (RigidBody* body : fastBodies) {
+        float radius = sweepRadius(*body);
+        glm::vec3 motion = body->position - body->previousPosition;
+        BoundingBox swept(glm::min(body->previousPosition, body->position) - glm::vec3(radius),
+                          glm::max(body->previousPosition, body->position) + glm::vec3(radius));
+        SweepHit first{2.0f, glm::vec3(0.0f), 0.0f};
+        uint32_t hitIndex = UINT32_MAX;
+        queryTree.query(swept.min, swept.max, [&](uint32_t index) {
+            RigidBody* other = bodies[index];
+            if (other == body) return;
+            // Bodies stopped earlier in this loop have moved back since the tree was fit, so recheck them
+            if (!swept.checkCollision(pathBounds(*other))) return;
+
+            // Ties go to the body added first, whatever order the tree visits them in
+            SweepHit hit{};
+            if (sweepBody(*body, *other, kSweepTolerance, hit, sweepScratch) &&
+                (hit.time < first.time || (hit.time == first.time && index < hitIndex))) {
+                first = hit;
+                hitIndex = index;
             }
+        });
+        if (hitIndex == UINT32_MAX) continue;
+
+        // Stop at the first contact and hand the response a contact there. The rest of the step is dropped.
+        body->position = body->previousPosition + motion * first.time;
+        body->updateBoundingBoxes();
+        sweptContacts.push_back({bodies[hitIndex], body, body->position - first.normal * radius, first.normal, 0.0f,
+                                 false});
+    }
+}
+
+void PhysicsWorld::detectCollisions() {
+    // Only body pairs whose aggregate bounds overlap get the per-box test. update() has refreshed the pairs.
+    const auto& pairs = broadphase->getPairs();
+
+    unsigned threadCount = jobSystem ? jobSystem->getThreadCount() : 1;
+    threadContacts.resize(threadCount);
+    threadMasks.resize(threadCount);
+    for (auto& buffer : threadContacts) {
+        buffer.clear();
+    }
+    chunkRanges.resize((pairs.size() + kPairChunkSize - 1) / kPairChunkSize);
+
+    // Each thread appends to its own buffer and records which part of it belongs to which chunk
+    runChunks(pairs.size(), kPairChunkSize, [&](size_t begin, size_t end, unsigned thread) {
+        std::vector<Contact>& buffer = threadContacts[thread];
+        size_t start = buffer.size();
+        for (size_t i = begin; i < end; ++i) {
+            // Resting bodies cannot start touching each other or static geometry
+            if (!isAwake(pairs[i].first) && !isAwake(pairs[i].second)) continue;
+            findContacts(pairs[i].first, pairs[i].second, buffer, threadMasks[thread]);
         }
+        chunkRanges[begin / kPairChunkSize] = {thread, start, buffer.size()};
+    });
+
+    // Merge in chunk order, which is the broadphase's pair order no matter which thread ran what
+    contacts.clear();
+    for (const ChunkRange& range : chunkRanges) {
+        const std::vector<Contact>& buffer = threadContacts[range.thread];
+        contacts.insert(contacts.end(), buffer.begin() + range.begin, buffer.begin() + range.end);
     }
 }
 
-void PhysicsWorld::resolveCollision(RigidBody* bodyA, RigidBody* bodyB) {
-    // Simple collision resolution logic
-    glm::vec3 relativeVelocity = bodyB->velocity - bodyA->velocity;
-    glm::vec3 collisionNormal = glm::normalize(bodyB->position - bodyA->position);
-    float velocityAlongNormal = glm::dot(relativeVelocity, collisionNormal);
+void PhysicsWorld::findContacts(RigidBody* bodyA, RigidBody* bodyB, std::vector<Contact>& out,
+                                std::vector<uint32_t>& masks) {
+    // Shapes against the analytic stadium get one exact contact, whatever the mesh resolution
+    if (bodyA->getStadiumCollider() && bodyB->shape.type != ShapeType::None) {
+        findStadiumContact(bodyA, bodyB, out);
+        return;
+    }
+    if (bodyB->getStadiumCollider() && bodyA->shape.type != ShapeType::None) {
+        findStadiumContact(bodyB, bodyA, out);
+        return;
+    }
 
-    if (velocityAlongNormal > 0) {
+    // Static geometry with a tree gets queried once per moving box instead of scanned linearly
+    if (bodyA->getBoxTree() && !bodyB->getBoxTree()) {
+        std::swap(bodyA, bodyB);
+    }
+
+    // Midphase: a box can only touch the other body inside the overlap of the two aggregates, so everything of A
+    // outside it is skipped before any per-box query. Compound bodies only pay for their parts near each other.
+    const BoundingBox& aggregateA = bodyA->aggregateBoundingBox;
+    const BoundingBox& aggregateB = bodyB->aggregateBoundingBox;
+    if (!aggregateA.checkCollision(aggregateB)) return;
+    BoundingBox region(glm::max(aggregateA.min, aggregateB.min), glm::min(aggregateA.max, aggregateB.max));
+
+    // Box pairs push apart along the axis they overlap least on, towards B's side
+    glm::vec3 centerOffset = bodyB->position - bodyA->position;
+    auto addContact = [&](const BoundingBox& boxA, const glm::vec3& minB, const glm::vec3& maxB) {
+        glm::vec3 overlapMin = glm::max(boxA.min, minB);
+        glm::vec3 overlapMax = glm::min(boxA.max, maxB);
+        glm::vec3 overlap = overlapMax - overlapMin;
+        int axis = 0;
+        if (overlap.y < overlap[axis]) axis = 1;
+        if (overlap.z < overlap[axis]) axis = 2;
+
+        float boxOffset = (minB[axis] + maxB[axis]) - (boxA.min[axis] + boxA.max[axis]);
+        float direction = boxOffset != 0.0f ? boxOffset : centerOffset[axis];
+        glm::vec3 normal(0.0f);
+        normal[axis] = direction < 0.0f ? -1.0f : 1.0f;
+        out.push_back({bodyA, bodyB, (overlapMin + overlapMax) * 0.5f, normal, overlap[axis], true});
+    };
+    const std::vector<BoundingBox>& boxesB = bodyB->getCollisionBoxes();
+    if (const BVH* treeB = bodyB->getBoxTree()) {
+        for (const auto& boxA : bodyA->getCollisionBoxes()) {
+            if (!boxA.checkCollision(region)) continue;
+            treeB->query(boxA.min, boxA.max, [&](uint32_t index) {
+                const BoundingBox& boxB = boxesB[index];
+                addContact(boxA, boxB.min, boxB.max);
+            });
+        }
         return;
     }
 
-    float restitution = 0.5f; // Coefficient of restitution
-    float j = -(1 + restitution) * velocityAlongNormal;
-    j /= 1 / bodyA->mass + 1 / bodyB->mass;
+    const BoundingBoxSoA& boxSetB = bodyB->getCollisionBoxSet();
+    for (const auto& boxA : bodyA->getCollisionBoxes()) {
+        if (!boxA.checkCollision(region)) continue;
+        boxSetB.forEachOverlap(boxA, masks, [&](size_t index) {
+            const BoundingBox& boxB = boxesB[index];
+            addContact(boxA, boxB.min, boxB.max);
+        });
+    }
+}
 
-    glm::vec3 impulse = j * collisionNormal;
-    bodyA->velocity -= impulse / bodyA->mass;
-    bodyB->velocity += impulse / bodyB->mass;
+void PhysicsWorld::findStadiumContact(RigidBody* stadium, RigidBody* body, std::vector<Contact>& out) {
+    const StadiumCollider& collider = *stadium->getStadiumCollider();
+    StadiumContact hit{};
+    bool touching;
+    if (body->shape.type == ShapeType::Disc) {
+        glm::vec3 axis = body->orientation * glm::vec3(0.0f, 1.0f, 0.0f);
+        touching = collider.collideDisc(body->position, axis, body->shape.radius, hit);
+    } else {
+        touching = collider.collideSphere(body->position, body->shape.radius, hit);
+    }
+    if (touching) {
+        out.push_back({stadium, body, hit.point, hit.normal, hit.depth, false});
+    }
 }
 
-void PhysicsWorld::renderDebug(ShaderProgram &shader) const {
-    // Render all bounding boxes
-    for (RigidBody* body : bodies) {
-        if(body->boundingBoxes.size() < 100) {
-            for (const auto box : body->boundingBoxes) {
-                box->renderDebug(shader);
+void PhysicsWorld::buildManifolds(size_t sweptBegin) {
+    // The narrowphase emits each pair's contacts back to back, so every run of equal pairs is one manifold
+    contactCache.beginStep();
+    const auto& manifolds = contactCache.getManifolds();
+    size_t narrowphaseManifolds = 0;
+    for (size_t begin = 0; begin < contacts.size();) {
+        size_t end = begin + 1;
+        while (end < contacts.size() && end != sweptBegin &&
+               contacts[end].bodyA == contacts[begin].bodyA && contacts[end].bodyB == contacts[begin].bodyB) {
+            ++end;
+        }
+
+        // A swept contact only counts when the narrowphase found nothing for that pair
+        bool duplicate = false;
+        if (begin < sweptBegin) {
+            narrowphaseManifolds = manifolds.size() + 1;
+        } else {
+            for (size_t i = 0; i < narrowphaseManifolds && !duplicate; ++i) {
+                duplicate = manifolds[i].bodyA == contacts[begin].bodyA && manifolds[i].bodyB == contacts[begin].bodyB;
             }
+        }
+        if (!duplicate) {
+            ContactManifold manifold{};
+            buildManifold(&contacts[begin], end - begin, manifold);
+            contactCache.add(manifold);
+        }
+        begin = end;
+    }
+}
+
+void PhysicsWorld::wakeTouchedBodies() {
+    wakeIslands.clear();
+    for (const Contact& contact : contacts) {
+        if (contact.bodyA->sleeping && isAwake(contact.bodyB)) wakeIslands.push_back(contact.bodyA->sleepIsland);
+        if (contact.bodyB->sleeping && isAwake(contact.bodyA)) wakeIslands.push_back(contact.bodyB->sleepIsland);
+    }
+    if (wakeIslands.empty()) return;
+
+    // Wake everything that fell asleep with the touched bodies, not just the bodies themselves, so a stack
+    // does not come apart one body per step
+    for (RigidBody* body : bodies) {
+        if (body->sleeping && std::find(wakeIslands.begin(), wakeIslands.end(), body->sleepIsland) != wakeIslands.end()) {
+            body->sleeping = false;
+            body->sleepTimer = 0.0f;
+        }
+    }
+}
+
+uint32_t PhysicsWorld::findIsland(uint32_t id) {
+    while (islandParents[id] != id) {
+        islandParents[id] = islandParents[islandParents[id]];
+        id = islandParents[id];
+    }
+    return id;
+}
+
+void PhysicsWorld::updateSleep(float deltaTime) {
+    awakeCount = 0;
+    if (!sleepSettings.enabled) {
+        for (RigidBody* body : bodies) {
+            body->sleeping = false;
+            body->sleepTimer = 0.0f;
+            if (body->mass < FLT_MAX) awakeCount++;
+        }
+        return;
+    }
+
+    // Islands are bodies linked by this step's manifolds. Static bodies do not link anything, or the whole
+    // stadium would be one island. Ids are pool slots, so they index these arrays directly.
+    islandParents.resize(bodyPool.slotCount());
+    islandTimers.assign(bodyPool.slotCount(), FLT_MAX);
+    for (uint32_t i = 0; i < islandParents.size(); ++i) {
+        islandParents[i] = i;
+    }
+    for (const ContactManifold& manifold : contactCache.getManifolds()) {
+        if (!isAwake(manifold.bodyA) || !isAwake(manifold.bodyB)) continue;
+        uint32_t a = findIsland(manifold.bodyA->id);
+        uint32_t b = findIsland(manifold.bodyB->id);
+        // The lower id always becomes the root, so islands come out the same whatever the manifold order
+        if (a < b) islandParents[b] = a;
+        else if (b < a) islandParents[a] = b;
+    }
+
+    for (RigidBody* body : bodies) {
+        if (!isAwake(body)) continue;
+        glm::vec3 omega = glm::transpose(glm::mat3_cast(body->orientation)) * body->angularVelocity;
+        float energy = 0.5f * glm::dot(body->velocity, body->velocity) +
+                       0.5f * glm::dot(omega, body->inertiaTensor * omega) / body->mass;
+        body->sleepTimer = energy < sleepSettings.energy ? body->sleepTimer + deltaTime : 0.0f;
+        float& islandTimer = islandTimers[findIsland(body->id)];
+        islandTimer = std::min(islandTimer, body->sleepTimer);
+    }
+
+    // An island sleeps once its most restless body has been resting long enough
+    for (RigidBody* body : bodies) {
+        if (!isAwake(body)) continue;
+        uint32_t island = findIsland(body->id);
+        if (islandTimers[island] < sleepSettings.timeToSleep) {
+            awakeCount++;
+            continue;
+        }
+        body->sleeping = true;
+        body->sleepIsland = island;
+        body->velocity = glm::vec3(0.0f);
+        body->angularVelocity = glm::vec3(0.0f);
+        body->previousPosition = body->position;
+        body->previousOrientation = body->orientation;
+    }
+}
+
+void PhysicsWorld::updateQueryTree() const {
+    if (!queryTreeStale && !queryTreeInvalid) return;
+
+    queryBounds.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        queryBounds[i] = bodies[i]->aggregateBoundingBox;
+    }
+    if (queryTreeInvalid) {
+        queryTree.build(queryBounds);
+    } else {
+        queryTree.refit(queryBounds);
+    }
+    queryTreeStale = false;
+    queryTreeInvalid = false;
+}
+
+size_t PhysicsWorld::queryAABB(const BoundingBox& bounds, RigidBody** results, size_t capacity,
+                               const RigidBody* ignore) const {
+    updateQueryTree();
+    size_t found = 0;
+    queryTree.query(bounds.min, bounds.max, [&](uint32_t index) {
+        RigidBody* body = bodies[index];
+        if (body == ignore || !anyBoxOverlaps(body, bounds)) return;
+        if (found < capacity) results[found] = body;
+        ++found;
+    });
+    return found;
+}
+
+size_t PhysicsWorld::overlapSphere(const glm::vec3& center, float radius, RigidBody** results, size_t capacity,
+                                   const RigidBody* ignore) const {
+    updateQueryTree();
+    size_t found = 0;
+    queryTree.query(center - radius, center + radius, [&](uint32_t index) {
+        RigidBody* body = bodies[index];
+        if (body == ignore || !anyBoxInSphere(body, center, radius)) return;
+        if (found < capacity) results[found] = body;
+        ++found;
+    });
+    return found;
+}
+
+bool PhysicsWorld::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit,
+                           const RigidBody* ignore) const {
+    float length = glm::length(direction);
+    if (length <= 0.0f) return false;
+    glm::vec3 unitDirection = direction / length;
+    BVHRay ray(origin, unitDirection);
+
+    updateQueryTree();
+    RigidBody* closestBody = nullptr;
+    const BoundingBox* closestBox = nullptr;
+    float closest = maxDistance;
+
+    auto testBox = [&](RigidBody* body, const BoundingBox& box) {
+        float entry;
+        if (ray.enters(box.min, box.max, closest, entry)) {
+            closest = entry;
+            closestBody = body;
+            closestBox = &box;
+        }
+    };
+
+    queryTree.queryRay(origin, unitDirection, maxDistance, [&](uint32_t index) {
+        RigidBody* body = bodies[index];
+        if (body == ignore) return closest;
+        const std::vector<BoundingBox>& boxes = body->getCollisionBoxes();
+        if (const BVH* tree = body->getBoxTree()) {
+            tree->queryRay(origin, unitDirection, closest, [&](uint32_t boxIndex) {
+                testBox(body, boxes[boxIndex]);
+                return closest;
+            });
         } else {
-            for(int i = 0; i < 100; ++i) {
-                body->boundingBoxes[i]->renderDebug(shader);
+            for (const BoundingBox& box : boxes) {
+                testBox(body, box);
             }
         }
+        return closest;
+    });
+    if (!closestBody) return false;
+
+    hit.body = closestBody;
+    hit.distance = closest;
+    hit.point = origin + unitDirection * closest;
+    hit.normal = -unitDirection;
+    if (closest > 0.0f) {
+        // The entered face is on the axis whose slab the ray crossed last
+        glm::vec3 t0 = (closestBox->min - origin) * ray.inverseDirection;
+        glm::vec3 t1 = (closestBox->max - origin) * ray.inverseDirection;
+        glm::vec3 entries = glm::min(t0, t1);
+        int axis = entries.x >= entries.y ? (entries.x >= entries.z ? 0 : 2) : (entries.y >= entries.z ? 1 : 2);
+        hit.normal = glm::vec3(0.0f);
+        hit.normal[axis] = unitDirection[axis] > 0.0f ? -1.0f : 1.0f;
     }
+    return true;
 }
@@ -1,19 +1,164 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <functional>
 #include <glm/glm.hpp>
 #include "RigidBody.h"
-#include "ShaderProgram.h"
+#include "BVH.h"
+#include "Broadphase.h"
+#include "Contact.h"
+#include "ContactManifold.h"
+#include "ContactSolver.h"
+#include "ContinuousCollision.h"
+#include "Pool.h"
+#include "PhysicsStats.h"
 
+class JobSystem;
+class PhysicsWorld;
+
+enum class BroadphaseType {
+    BruteForce,
+    SweepAndPrune,
+    UniformGrid
+};
+
+struct SleepSettings {
+    bool enabled = true;
+    float energy = 0.01f;      // Kinetic energy per unit mass, in J/kg, below which a body counts as resting
+    float timeToSleep = 0.5f;  // Seconds every body in an island has to stay resting before the island sleeps
+};
+
+using BodyHandle = Handle<RigidBody>;
+
+struct RaycastHit {
+    RigidBody* body = nullptr;
+    float distance = 0.0f;  // Along the normalized ray direction
+    glm::vec3 point{0.0f};
+    glm::vec3 normal{0.0f};  // Face of the box the ray entered, or -direction when it starts inside one
+};
+
+// A world's dynamic state in one flat buffer, written by PhysicsWorld::snapshot and read back by restore.
+// The buffer keeps its capacity, so snapshotting the same scene again only copies.
+class PhysicsSnapshot {
+public:
+    [[nodiscard]] bool empty() const { return size == 0; }
+    [[nodiscard]] size_t sizeBytes() const { return size; }
+
+private:
+    friend class PhysicsWorld;
+
+    std::vector<uint8_t> buffer;
+    size_t size = 0;
+    const PhysicsWorld* world = nullptr;  // The cached manifolds point at this world's bodies
+};
+
+// Owns its bodies in a pool. Pointers from getBody stay valid until the body is destroyed or the world cleared;
+// handles outlive that and simply stop resolving.
 class PhysicsWorld {
 public:
-    std::vector<RigidBody*> bodies;
+    std::vector<RigidBody*> bodies;  // Every live body, for iteration. Read only, use create/destroyBody to change it.
+    glm::vec3 gravity{0.0f};  // Applied to every body with finite mass before integrating
+    SolverSettings solverSettings;  // Iteration budget and response tuning, per world
+    SleepSettings sleepSettings;
+
+    PhysicsWorld();
+
+    // A mass of FLT_MAX makes the body immovable. Add localBoxes after creating it, then call updateBoundingBoxes.
+    BodyHandle createBody(const glm::vec3& position, const glm::vec3& size, float mass);
+    BodyHandle createImmovableBody(const glm::vec3& position, const glm::vec3& size);
+    void destroyBody(BodyHandle handle);
+    // Destroys every body. Pool blocks and all per-step buffers are kept, so refilling the world allocates nothing
+    // new, and it fills up exactly as a new world would.
+    void clear();
+    [[nodiscard]] RigidBody* getBody(BodyHandle handle) const { return bodyPool.get(handle); }
+    [[nodiscard]] BodyHandle getHandle(const RigidBody* body) const { return bodyPool.handleAt(body->id); }
+
+    // Copies every body's motion, mass properties, sleep state and world-space boxes, plus the contact cache that
+    // warm starts the next step, into snapshot. Allocates nothing unless the snapshot's buffer has to grow.
+    void snapshot(PhysicsSnapshot& snapshot) const;
+    // Puts the world back into the state the snapshot was taken in, so the following steps play out exactly as
+    // they did after it was taken. Fails without changing anything if the snapshot is from another world or
+    // bodies were created or destroyed since.
+    bool restore(const PhysicsSnapshot& snapshot);
 
-    void addBody(RigidBody* body);
+    void setBroadphase(BroadphaseType type);
+    [[nodiscard]] BroadphaseType getBroadphaseType() const { return broadphaseType; }
     void update(float deltaTime);
-    void renderDebug(ShaderProgram &shader) const;
+    void interpolate(float alpha);  // Sets each body's render transform between its last two physics states
+
+    // Integration and narrowphase are split across the job system's threads. nullptr runs them on the calling
+    // thread. Contacts come out in the same order either way, so results do not depend on the thread count.
+    void setJobSystem(JobSystem* jobs) { jobSystem = jobs; }
+    [[nodiscard]] const std::vector<Contact>& getContacts() const { return contacts; }
+    // One manifold per touching body pair, what the response actually works on
+    [[nodiscard]] const std::vector<ContactManifold>& getManifolds() const { return contactCache.getManifolds(); }
+    // Timing and convergence of the last step's contact solve
+    [[nodiscard]] const SolverStats& getSolverStats() const { return solver.getStats(); }
+    // Movable bodies that were integrated in the last step
+    [[nodiscard]] size_t getAwakeCount() const { return awakeCount; }
+    // Phase timings and work counts of the last step, and of the steps before it
+    [[nodiscard]] const PhysicsStepStats& getStepStats() const { return stepStats; }
+    [[nodiscard]] const PhysicsStatsHistory& getStatsHistory() const { return statsHistory; }
+
+    // Spatial queries against the bodies' collision boxes, through a tree over their aggregate bounds that is
+    // refit on the first query after each step. Results go into the caller's buffer, so nothing is allocated
+    // unless bodies were created or destroyed since the last query. They return how many bodies matched, which
+    // can be more than capacity; only the first capacity of them are written. ignore is left out of the results.
+    size_t queryAABB(const BoundingBox& bounds, RigidBody** results, size_t capacity,
+                     const RigidBody* ignore = nullptr) const;
+    size_t overlapSphere(const glm::vec3& center, float radius, RigidBody** results, size_t capacity,
+                         const RigidBody* ignore = nullptr) const;
+    // Closest box hit within maxDistance along direction, which does not need to be normalized
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit,
+                 const RigidBody* ignore = nullptr) const;
 
 private:
+    // Where one narrowphase chunk left its contacts in its thread's buffer
+    struct ChunkRange {
+        unsigned thread;
+        size_t begin;
+        size_t end;
+    };
+
+    BroadphaseType broadphaseType;
+    std::unique_ptr<Broadphase> broadphase;
+    JobSystem* jobSystem = nullptr;
+
+    std::vector<std::vector<Contact>> threadContacts;
+    std::vector<std::vector<uint32_t>> threadMasks;  // Per-thread scratch for BoundingBoxSoA::forEachOverlap
+    std::vector<ChunkRange> chunkRanges;
+    std::vector<Contact> contacts;
+    std::vector<Contact> sweptContacts;
+    std::vector<RigidBody*> fastBodies;  // Bodies swept this step
+    SweepScratch sweepScratch;
+    ContactCache contactCache;
+    ContactSolver solver;
+    Pool<RigidBody> bodyPool;
+    std::vector<uint32_t> bodyIndices;  // Position in bodies for each pool slot
+    std::vector<uint32_t> islandParents;  // Union-find over body ids, rebuilt from the manifolds each step
+    std::vector<float> islandTimers;      // Shortest sleep timer in each island, indexed by root
+    std::vector<uint32_t> wakeIslands;
+    size_t awakeCount = 0;
+    PhysicsStepStats stepStats;
+    PhysicsStatsHistory statsHistory;
+    // Query tree over the bodies' aggregate bounds, indexed like bodies. Brought up to date lazily by queries.
+    // sweepFastBodies borrows it, fit around each body's path over the step, and leaves it stale.
+    mutable BVH queryTree;
+    mutable std::vector<BoundingBox> queryBounds;
+    mutable bool queryTreeStale = true;   // Bodies moved: refit
+    mutable bool queryTreeInvalid = true; // Bodies were added or removed: rebuild
+
+    void runChunks(size_t count, size_t chunkSize, const std::function<void(size_t, size_t, unsigned)>& fn);
+    void integrateBodies(float deltaTime);
+    void sweepFastBodies();
     void detectCollisions();
-    static void resolveCollision(RigidBody* bodyA, RigidBody* bodyB);
+    static void findContacts(RigidBody* bodyA, RigidBody* bodyB, std::vector<Contact>& out,
+                             std::vector<uint32_t>& masks);
+    static void findStadiumContact(RigidBody* stadium, RigidBody* body, std::vector<Contact>& out);
+    void buildManifolds(size_t sweptBegin);
+    void wakeTouchedBodies();
+    void updateSleep(float deltaTime);
+    uint32_t findIsland(uint32_t id);
+    void updateQueryTree() const;
 };
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Refers to an object in a Pool. The generation is bumped every time a slot is released, so a handle to a
+// destroyed object stops resolving instead of silently pointing at whatever reused its slot.
+template<typename T>
+struct Handle {
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+    uint32_t index = kInvalidIndex;
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool isValid() const { return index != kInvalidIndex; }
+    bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Handle& other) const { return !(*this == other); }
+};
+
+// Fixed-size blocks of default-constructed objects. Objects never move, so pointers stay valid until their slot
+// is released, and released objects are kept for reuse rather than destroyed: whatever heap memory they own
+// (box lists and the like) is reused by the next object allocated in that slot.
+// Slots are handed out lowest first, both from a fresh pool and after clear(), so a cleared pool fills up the
+// same way a new one does.
+template<typename T>
+class Pool {
+public:
+    static constexpr uint32_t kBlockSize = 256;
+
+    // The object keeps whatever state it had when its slot was last released; callers reset it
+    Handle<T> allocate();
+    // Releases the slot. Does nothing for stale or invalid handles.
+    void release(Handle<T> handle);
+    // Releases every slot but keeps the blocks
+    void clear();
+
+    // nullptr for stale or invalid handles
+    [[nodiscard]] T* get(Handle<T> handle) const;
+    [[nodiscard]] T& operator[](uint32_t index) const { return blocks[index / kBlockSize][index % kBlockSize]; }
+    [[nodiscard]] Handle<T> handleAt(uint32_t index) const { return {index, generations[index]}; }
+    [[nodiscard]] bool isLive(uint32_t index) const { return index < live.size() && live[index]; }
+
+    [[nodiscard]] uint32_t size() const { return liveCount; }
+    [[nodiscard]] uint32_t slotCount() const { return static_cast<uint32_t>(generations.size()); }
+
+private:
+    std::vector<std::unique_ptr<T[]>> blocks;
+    std::vector<uint32_t> generations;
+    std::vector<uint8_t> live;
+    std::vector<uint32_t> freeSlots;  // Popped from the back, so kept in descending order when refilled
+    uint32_t liveCount = 0;
+
+    void refillFreeSlots(uint32_t begin, uint32_t end);
+};
+
+template<typename T>
+Handle<T> Pool<T>::allocate() {
+    if (freeSlots.empty()) {
+        auto begin = static_cast<uint32_t>(generations.size());
+        blocks.push_back(std::make_unique<T[]>(kBlockSize));
+        generations.resize(begin + kBlockSize, 0);
+        live.resize(begin + kBlockSize, 0);
+        refillFreeSlots(begin, begin + kBlockSize);
+    }
+    uint32_t index = freeSlots.back();
+    freeSlots.pop_back();
+    live[index] = 1;
+    liveCount++;
+    return {index, generations[index]};
+}
+
+template<typename T>
+void Pool<T>::release(Handle<T> handle) {
+    if (!get(handle)) return;
+    live[handle.index] = 0;
+    generations[handle.index]++;
+    liveCount--;
+    freeSlots.push_back(handle.index);
+}
+
+template<typename T>
+void Pool<T>::clear() {
+    for (uint32_t i = 0; i < generations.size(); ++i) {
+        if (live[i]) {
+            live[i] = 0;
+            generations[i]++;
+        }
+    }
+    liveCount = 0;
+    freeSlots.clear();
+    refillFreeSlots(0, slotCount());
+}
+
+template<typename T>
+T* Pool<T>::get(Handle<T> handle) const {
+    if (handle.index >= generations.size() || !live[handle.index] || generations[handle.index] != handle.generation) {
+        return nullptr;
+    }
+    return &(*this)[handle.index];
+}
+
+template<typename T>
+void Pool<T>::refillFreeSlots(uint32_t begin, uint32_t end) {
+    for (uint32_t i = end; i > begin; --i) {
+        freeSlots.push_back(i - 1);
+    }
+}
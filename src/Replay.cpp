@@ -0,0 +1,436 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "Replay.h"
+
+namespace {
+    constexpr char kMagic[4] = {'B', 'B', 'R', 'P'};
+    constexpr uint32_t kVersion = 7;
+
+    // Per-step record tags
+    enum RecordTag : uint8_t {
+        StepEnd = 0,
+        BodyStateRecord = 1,
+        BroadphaseRecord = 2,
+        ChecksumRecord = 3,
+        EndRecord = 4  // Written once by save, with the step count, so a file cut short can be told apart
+    };
+
+    enum BodyFlags : uint8_t {
+        Immovable = 1,
+        HasTree = 2,
+        HasStadiumCollider = 4,
+        ContinuousCollision = 8
+    };
+
+    // Smallest a body's entry in the header can be: no stadium collider and no boxes
+    constexpr size_t kMinBodyRecordSize = 2 * sizeof(uint8_t) + 4 * sizeof(float) + 3 * sizeof(glm::vec3) +
+                                          sizeof(glm::quat) + 2 * sizeof(glm::mat3) + sizeof(uint32_t);
+    constexpr size_t kBoxRecordSize = 2 * sizeof(glm::vec3);
+
+    bool isBroadphaseType(uint8_t value) {
+        return value <= static_cast<uint8_t>(BroadphaseType::UniformGrid);
+    }
+
+    void hashBytes(uint64_t& hash, const void* data, size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+
+    void setBodyState(RigidBody& body, const glm::vec3& position, const glm::vec3& velocity,
+                      const glm::vec3& angularVelocity, const glm::quat& orientation) {
+        body.position = position;
+        body.velocity = velocity;
+        body.angularVelocity = angularVelocity;
+        body.orientation = orientation;
+        body.updateBoundingBoxes();
+    }
+}
+
+uint64_t worldChecksum(const PhysicsWorld& world) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const RigidBody* body : world.bodies) {
+        hashBytes(hash, &body->position, sizeof(body->position));
+        hashBytes(hash, &body->velocity, sizeof(body->velocity));
+        hashBytes(hash, &body->angularVelocity, sizeof(body->angularVelocity));
+        hashBytes(hash, &body->orientation, sizeof(body->orientation));
+    }
+    return hash;
+}
+
+/* ----------------------RECORDER-------------------------- */
+
+ReplayRecorder::ReplayRecorder(uint32_t checksumInterval)
+        : checksumInterval(checksumInterval > 0 ? checksumInterval : 1) {}
+
+template<typename T>
+void ReplayRecorder::write(const T& value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+void ReplayRecorder::begin(const PhysicsWorld& world, float stepsPerSecond) {
+    buffer.clear();
+    step = 0;
+
+    write(kMagic);
+    write(kVersion);
+    write(stepsPerSecond);
+    write(checksumInterval);
+    write(world.gravity);
+    write(world.solverSettings);
+    write(static_cast<uint8_t>(world.sleepSettings.enabled));
+    write(world.sleepSettings.energy);
+    write(world.sleepSettings.timeToSleep);
+    write(static_cast<uint8_t>(world.getBroadphaseType()));
+    write(static_cast<uint32_t>(world.bodies.size()));
+
+    lastStates.clear();
+    for (const RigidBody* body : world.bodies) {
+        uint8_t flags = 0;
+        if (body->mass == FLT_MAX) flags |= Immovable;
+        if (body->getBoxTree()) flags |= HasTree;
+        if (body->getStadiumCollider()) flags |= HasStadiumCollider;
+        if (body->continuousCollision) flags |= ContinuousCollision;
+        write(flags);
+        write(body->mass);
+        write(body->position);
+        write(body->velocity);
+        write(body->angularVelocity);
+        write(body->orientation);
+        write(body->inertiaTensor);
+        write(body->inverseInertiaLocal);
+        write(body->spinFriction);
+        write(body->friction);
+        write(static_cast<uint8_t>(body->shape.type));
+        write(body->shape.radius);
+        if (const StadiumCollider* collider = body->getStadiumCollider()) {
+            write(collider->getPosition());
+            write(collider->getRadius());
+            write(collider->getCurvature());
+        }
+        const std::vector<BoundingBox>& localBoxes =
+                body->staticGeometry ? body->staticGeometry->getLocalBoxes() : body->localBoxes;
+        write(static_cast<uint32_t>(localBoxes.size()));
+        for (const BoundingBox& box : localBoxes) {
+            write(box.min);
+            write(box.max);
+        }
+        lastStates.push_back({body->position, body->velocity, body->angularVelocity, body->orientation});
+    }
+    lastBroadphase = world.getBroadphaseType();
+}
+
+void ReplayRecorder::captureInputs(const PhysicsWorld& world) {
+    if (world.getBroadphaseType() != lastBroadphase) {
+        lastBroadphase = world.getBroadphaseType();
+        write(BroadphaseRecord);
+        write(static_cast<uint8_t>(lastBroadphase));
+    }
+
+    // Anything that differs from the end of the last step was changed from outside the simulation
+    for (uint32_t i = 0; i < lastStates.size() && i < world.bodies.size(); ++i) {
+        const RigidBody* body = world.bodies[i];
+        BodyState state{body->position, body->velocity, body->angularVelocity, body->orientation};
+        if (std::memcmp(&state, &lastStates[i], sizeof(BodyState)) != 0) {
+            write(BodyStateRecord);
+            write(i);
+            write(state);
+            lastStates[i] = state;
+        }
+    }
+}
+
+void ReplayRecorder::endStep(const PhysicsWorld& world) {
+    write(StepEnd);
+    ++step;
+    if (step % checksumInterval == 0) {
+        write(ChecksumRecord);
+        write(worldChecksum(world));
+    }
+
+    for (uint32_t i = 0; i < lastStates.size() && i < world.bodies.size(); ++i) {
+        const RigidBody* body = world.bodies[i];
+        lastStates[i] = {body->position, body->velocity, body->angularVelocity, body->orientation};
+    }
+}
+
+bool ReplayRecorder::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open replay file for writing: " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    uint8_t end[1 + sizeof(uint32_t)] = {EndRecord};
+    std::memcpy(end + 1, &step, sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(end), sizeof(end));
+    return static_cast<bool>(file);
+}
+
+/* ----------------------PLAYER-------------------------- */
+
+template<typename T>
+bool ReplayPlayer::read(T& value) {
+    if (readOffset + sizeof(T) > buffer.size()) return false;
+    std::memcpy(&value, buffer.data() + readOffset, sizeof(T));
+    readOffset += sizeof(T);
+    return true;
+}
+
+bool ReplayPlayer::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open replay file: " << path << std::endl;
+        return false;
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    readOffset = 0;
+
+    char magic[4];
+    uint32_t version = 0;
+    uint32_t checksumInterval = 0;
+    uint8_t sleepEnabled = 0;
+    uint8_t broadphaseByte = 0;
+    uint32_t bodyCount = 0;
+    if (!read(magic) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || !read(version) || version != kVersion) {
+        std::cerr << "Not a replay file, or from another version: " << path << std::endl;
+        return false;
+    }
+    if (!read(stepsPerSecond) || !read(checksumInterval) || !read(gravity) || !read(solverSettings) ||
+        !read(sleepEnabled) || !read(sleepSettings.energy) || !read(sleepSettings.timeToSleep) ||
+        !read(broadphaseByte) || !read(bodyCount)) {
+        std::cerr << "Replay header is truncated: " << path << std::endl;
+        return false;
+    }
+    // Counts come straight from the file, so check they fit in what is left of it before allocating for them
+    if (bodyCount > (buffer.size() - readOffset) / kMinBodyRecordSize) {
+        std::cerr << "Replay header is truncated: " << path << std::endl;
+        return false;
+    }
+    if (!isBroadphaseType(broadphaseByte)) {
+        std::cerr << "Replay uses an unknown broadphase: " << path << std::endl;
+        return false;
+    }
+    sleepSettings.enabled = sleepEnabled != 0;
+    broadphase = static_cast<BroadphaseType>(broadphaseByte);
+
+    initialBodies.clear();
+    initialBodies.resize(bodyCount);
+    for (BodyRecord& body : initialBodies) {
+        uint8_t flags = 0;
+        uint8_t shapeType = 0;
+        uint32_t boxCount = 0;
+        bool ok = read(flags) && read(body.mass) && read(body.position) && read(body.velocity) &&
+                  read(body.angularVelocity) && read(body.orientation) && read(body.inertiaTensor) &&
+                  read(body.inverseInertiaLocal) && read(body.spinFriction) && read(body.friction) &&
+                  read(shapeType) && read(body.shape.radius);
+        body.immovable = (flags & Immovable) != 0;
+        body.continuousCollision = (flags & ContinuousCollision) != 0;
+        body.shape.type = static_cast<ShapeType>(shapeType);
+        std::shared_ptr<const StadiumCollider> stadiumCollider;
+        if (ok && (flags & HasStadiumCollider)) {
+            glm::vec3 colliderPosition;
+            float colliderRadius = 0.0f, colliderCurvature = 0.0f;
+            ok = read(colliderPosition) && read(colliderRadius) && read(colliderCurvature);
+            stadiumCollider = std::make_shared<StadiumCollider>(colliderPosition, colliderRadius, colliderCurvature);
+        }
+        ok = ok && read(boxCount) && boxCount <= (buffer.size() - readOffset) / kBoxRecordSize;
+        body.boxes.resize(ok ? boxCount : 0);
+        for (BoundingBox& box : body.boxes) {
+            ok = ok && read(box.min) && read(box.max);
+        }
+        if (!ok) {
+            std::cerr << "Replay body list is truncated: " << path << std::endl;
+            return false;
+        }
+        if ((flags & HasTree) || stadiumCollider) {
+            body.staticGeometry = StaticGeometry::create(body.position, body.boxes, (flags & HasTree) != 0,
+                                                         std::move(stadiumCollider));
+            body.boxes.clear();
+        }
+    }
+    inputsOffset = readOffset;
+
+    // Count the steps up front so callers know how long the replay runs, and make sure every record is whole
+    stepCount = 0;
+    bool stepOpen = false;
+    bool ended = false;
+    while (readOffset < buffer.size() && !ended) {
+        size_t recordOffset = readOffset;
+        uint8_t tag = buffer[readOffset++];
+        size_t size = 0;
+        switch (tag) {
+            case StepEnd: ++stepCount; stepOpen = false; break;
+            case BodyStateRecord: size = sizeof(uint32_t) + 13 * sizeof(float); stepOpen = true; break;
+            case BroadphaseRecord: size = sizeof(uint8_t); stepOpen = true; break;
+            case ChecksumRecord: size = sizeof(uint64_t); break;
+            case EndRecord: size = sizeof(uint32_t); ended = true; break;
+            default:
+                std::cerr << "Replay contains an unknown record at byte " << recordOffset << std::endl;
+                return false;
+        }
+        if (size > buffer.size() - readOffset ||
+            (tag == BroadphaseRecord && !isBroadphaseType(buffer[readOffset]))) {
+            std::cerr << "Replay inputs are truncated or corrupt at byte " << recordOffset << ": " << path << std::endl;
+            return false;
+        }
+        readOffset += size;
+    }
+
+    // The log has to finish on the end record, right after a whole step, and agree on how many steps it holds
+    uint32_t recordedSteps = 0;
+    if (ended) std::memcpy(&recordedSteps, buffer.data() + readOffset - sizeof(uint32_t), sizeof(uint32_t));
+    if (!ended || stepOpen || readOffset != buffer.size() || recordedSteps != stepCount) {
+        std::cerr << "Replay inputs are truncated after step " << stepCount << ": " << path << std::endl;
+        return false;
+    }
+    readOffset = inputsOffset;
+    step = 0;
+    divergedStep = 0;
+    checksumsVerified = 0;
+    return true;
+}
+
+void ReplayPlayer::createWorld(PhysicsWorld& world) {
+    for (const BodyRecord& record : initialBodies) {
+        BodyHandle handle = record.immovable ? world.createImmovableBody(record.position, glm::vec3(1.0f))
+                                             : world.createBody(record.position, glm::vec3(1.0f), record.mass);
+        RigidBody* body = world.getBody(handle);
+        if (record.staticGeometry) {
+            body->setStaticGeometry(record.staticGeometry);
+        } else {
+            body->localBoxes = record.boxes;
+            body->updateBoundingBoxes();
+        }
+    }
+    restore(world);
+}
+
+bool ReplayPlayer::restoreInitialState(PhysicsWorld& world) {
+    if (world.bodies.size() != initialBodies.size()) {
+        std::cerr << "Replay has " << initialBodies.size() << " bodies but the world has " << world.bodies.size()
+                  << std::endl;
+        return false;
+    }
+    restore(world);
+    return true;
+}
+
+void ReplayPlayer::restore(PhysicsWorld& world) {
+    world.gravity = gravity;
+    world.solverSettings = solverSettings;
+    world.sleepSettings = sleepSettings;
+    if (world.getBroadphaseType() != broadphase) {
+        world.setBroadphase(broadphase);
+    }
+    for (size_t i = 0; i < initialBodies.size(); ++i) {
+        const BodyRecord& record = initialBodies[i];
+        RigidBody* body = world.bodies[i];
+        body->mass = record.mass;
+        body->inertiaTensor = record.inertiaTensor;
+        body->inverseInertiaLocal = record.inverseInertiaLocal;
+        body->spinFriction = record.spinFriction;
+        body->friction = record.friction;
+        body->sleeping = false;
+        body->sleepTimer = 0.0f;
+        body->shape = record.shape;
+        body->continuousCollision = record.continuousCollision;
+        body->position = record.position;
+        body->velocity = record.velocity;
+        body->angularVelocity = record.angularVelocity;
+        body->orientation = record.orientation;
+        body->force = glm::vec3(0.0f);
+        body->torque = glm::vec3(0.0f);
+        body->previousPosition = body->renderPosition = record.position;
+        body->previousOrientation = body->renderOrientation = record.orientation;
+        body->updateInertiaTensor();
+        // Static geometry is shared and never changes
+        if (!record.staticGeometry) {
+            body->localBoxes = record.boxes;
+            body->updateBoundingBoxes();
+        }
+    }
+    trackedBodies = world.bodies;
+    readOffset = inputsOffset;
+    step = 0;
+    divergedStep = 0;
+    checksumsVerified = 0;
+    rememberStates();
+}
+
+void ReplayPlayer::rememberStates() {
+    lastStates.resize(trackedBodies.size());
+    for (size_t i = 0; i < trackedBodies.size(); ++i) {
+        const RigidBody* body = trackedBodies[i];
+        lastStates[i].position = body->position;
+        lastStates[i].velocity = body->velocity;
+        lastStates[i].angularVelocity = body->angularVelocity;
+        lastStates[i].orientation = body->orientation;
+    }
+}
+
+void ReplayPlayer::applyInputs(PhysicsWorld& world) {
+    if (finished()) return;
+
+    // Live input (the camera, mostly) must not leak into the replay
+    for (size_t i = 0; i < trackedBodies.size(); ++i) {
+        RigidBody* body = trackedBodies[i];
+        const BodyRecord& last = lastStates[i];
+        if (body->position != last.position || body->velocity != last.velocity ||
+            body->angularVelocity != last.angularVelocity || body->orientation != last.orientation) {
+            setBodyState(*body, last.position, last.velocity, last.angularVelocity, last.orientation);
+        }
+    }
+
+    uint8_t tag = 0;
+    while (readOffset < buffer.size() && buffer[readOffset] != StepEnd) {
+        read(tag);
+        bool ok = true;
+        if (tag == BodyStateRecord) {
+            uint32_t index = 0;
+            glm::vec3 position(0.0f), velocity(0.0f), angularVelocity(0.0f);
+            glm::quat orientation(1.0f, 0.0f, 0.0f, 0.0f);
+            ok = read(index) && read(position) && read(velocity) && read(angularVelocity) && read(orientation);
+            if (ok && index < trackedBodies.size()) {
+                setBodyState(*trackedBodies[index], position, velocity, angularVelocity, orientation);
+            }
+        } else if (tag == BroadphaseRecord) {
+            uint8_t type = 0;
+            ok = read(type) && isBroadphaseType(type);
+            if (ok) world.setBroadphase(static_cast<BroadphaseType>(type));
+        }
+        if (!ok) {
+            // The log is cut short or damaged here, so nothing after this step can be trusted
+            if (!diverged()) divergedStep = step + 1;
+            step = stepCount;
+            readOffset = buffer.size();
+            return;
+        }
+    }
+}
+
+bool ReplayPlayer::endStep(const PhysicsWorld& world) {
+    if (finished()) return !diverged();
+
+    uint8_t tag = 0;
+    read(tag);  // StepEnd
+    ++step;
+    if (readOffset < buffer.size() && buffer[readOffset] == ChecksumRecord) {
+        uint64_t expected = 0;
+        read(tag);
+        read(expected);
+        if (worldChecksum(world) != expected) {
+            if (!diverged()) {
+                divergedStep = step;
+            }
+        } else {
+            ++checksumsVerified;
+        }
+    }
+    rememberStates();
+    return !diverged();
+}
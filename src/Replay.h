@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "PhysicsWorld.h"
+#include "RigidBody.h"
+
+// Deterministic session recording. A replay log holds the world's initial state (every body, including its
+// collision boxes) followed by the inputs applied before each fixed step, so a session recorded in the game can
+// be played back bit for bit in the game or in a headless run.
+//
+// An input is anything that changes a body or the world between steps: launches, the camera body following the
+// camera, switching broadphase from the UI. The recorder finds them by comparing each body against the state it
+// had at the end of the previous step, so callers do not have to report them. A checksum of all body state is
+// written every checksumInterval steps so a diverging replay is caught on the first mismatching checkpoint.
+//
+// Bodies added after recording starts are not part of the log.
+
+// FNV-1a over every body's position, velocity, angular velocity and orientation, in world order
+uint64_t worldChecksum(const PhysicsWorld& world);
+
+class ReplayRecorder {
+public:
+    explicit ReplayRecorder(uint32_t checksumInterval = 60);
+
+    // Writes the initial state. Call once every body is in the world, before the first step.
+    void begin(const PhysicsWorld& world, float stepsPerSecond);
+    // Call right before PhysicsWorld::update, records whatever changed since the last step
+    void captureInputs(const PhysicsWorld& world);
+    // Call right after PhysicsWorld::update
+    void endStep(const PhysicsWorld& world);
+
+    bool save(const std::string& path) const;
+    [[nodiscard]] uint32_t getStepCount() const { return step; }
+    [[nodiscard]] size_t getSizeBytes() const { return buffer.size(); }
+
+private:
+    struct BodyState {
+        glm::vec3 position;
+        glm::vec3 velocity;
+        glm::vec3 angularVelocity;
+        glm::quat orientation;
+    };
+
+    std::vector<uint8_t> buffer;
+    std::vector<BodyState> lastStates;
+    BroadphaseType lastBroadphase = BroadphaseType::SweepAndPrune;
+    uint32_t checksumInterval;
+    uint32_t step = 0;
+
+    template<typename T>
+    void write(const T& value);
+};
+
+class ReplayPlayer {
+public:
+    bool load(const std::string& path);
+
+    [[nodiscard]] float getStepsPerSecond() const { return stepsPerSecond; }
+    [[nodiscard]] uint32_t getStepCount() const { return stepCount; }
+    [[nodiscard]] uint32_t getStep() const { return step; }
+    [[nodiscard]] bool finished() const { return step >= stepCount; }
+    [[nodiscard]] bool diverged() const { return divergedStep != 0; }
+    [[nodiscard]] uint32_t getDivergedStep() const { return divergedStep; }
+    [[nodiscard]] uint32_t getChecksumsVerified() const { return checksumsVerified; }
+
+    // Fills an empty world with bodies rebuilt from the log
+    void createWorld(PhysicsWorld& world);
+    // Resets a world that was built the same way as the recorded one. Returns false if the body counts differ.
+    bool restoreInitialState(PhysicsWorld& world);
+
+    // Call right before PhysicsWorld::update. Undoes changes made outside the replay since the last step, then
+    // applies the recorded inputs. A damaged record ends the replay as diverged at this step.
+    void applyInputs(PhysicsWorld& world);
+    // Call right after PhysicsWorld::update. Returns false once a recorded checksum does not match.
+    bool endStep(const PhysicsWorld& world);
+
+private:
+    struct BodyRecord {
+        bool immovable;
+        bool continuousCollision;
+        float mass;
+        glm::vec3 position;
+        glm::vec3 velocity;
+        glm::vec3 angularVelocity;
+        glm::quat orientation;
+        glm::mat3 inertiaTensor;
+        glm::mat3 inverseInertiaLocal;
+        float spinFriction;
+        float friction;
+        CollisionShape shape;
+        // Built once when loading and shared by every world created from the replay
+        std::shared_ptr<const StaticGeometry> staticGeometry;
+        std::vector<BoundingBox> boxes;  // Body space, for bodies without static geometry
+    };
+
+    std::vector<uint8_t> buffer;
+    size_t readOffset = 0;
+    size_t inputsOffset = 0;  // Start of the per-step records
+
+    float stepsPerSecond = 240.0f;
+    glm::vec3 gravity{0.0f};
+    SolverSettings solverSettings;
+    SleepSettings sleepSettings;
+    BroadphaseType broadphase = BroadphaseType::SweepAndPrune;
+    std::vector<BodyRecord> initialBodies;
+    uint32_t stepCount = 0;
+
+    std::vector<RigidBody*> trackedBodies;
+    std::vector<BodyRecord> lastStates;  // Only the dynamic state fields are used
+    uint32_t step = 0;
+    uint32_t divergedStep = 0;
+    uint32_t checksumsVerified = 0;
+
+    template<typename T>
+    bool read(T& value);
+    void restore(PhysicsWorld& world);
+    void rememberStates();
+};
@@ -1,10 +1,27 @@
-#include <iostream>
 #include "RigidBody.h"
 
-RigidBody::RigidBody(const glm::vec3& pos, const glm::vec3& sz, float mass, std::vector<BoundingBox*> bboxes)
-        : position(pos), mass(mass), velocity(0.0f), acceleration(0.0f), force(0.0f),
-          angularVelocity(0.0f), torque(0.0f), orientation(glm::quat(1.0f, 0.0f, 0.0f, 0.0f)),
-          boundingBoxes(bboxes), VAO(0), VBO(0), EBO(0) {
+RigidBody::RigidBody() : RigidBody(glm::vec3(0.0f), glm::vec3(1.0f), 1.0f) {}
+
+RigidBody::RigidBody(const glm::vec3& pos, const glm::vec3& sz, float mass, std::vector<BoundingBox> bboxes) {
+    reset(pos, sz, mass);
+    localBoxes = std::move(bboxes);
+    updateBoundingBoxes(); // Initial update of bounding boxes
+}
+
+void RigidBody::reset(const glm::vec3& pos, const glm::vec3& sz, float bodyMass) {
+    position = pos;
+    velocity = glm::vec3(0.0f);
+    acceleration = glm::vec3(0.0f);
+    mass = bodyMass;
+    force = glm::vec3(0.0f);
+    angularVelocity = glm::vec3(0.0f);
+    torque = glm::vec3(0.0f);
+    orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    previousPosition = pos;
+    previousOrientation = orientation;
+    renderPosition = pos;
+    renderOrientation = orientation;
+
     float x2 = sz.x * sz.x;
     float y2 = sz.y * sz.y;
     float z2 = sz.z * sz.z;
@@ -14,16 +31,20 @@ RigidBody::RigidBody(const glm::vec3& pos, const glm::vec3& sz, float mass, std:
             0.0f, factor * (x2 + z2), 0.0f,
             0.0f, 0.0f, factor * (x2 + y2)
     );
-    inverseInertiaTensor = glm::inverse(inertiaTensor);
-    aggregateBoundingBox = BoundingBox(glm::vec3(-0.1), glm::vec3(0.1));
-
-    setupBuffers();
-
-    updateBoundingBoxes(); // Initial update of bounding boxes
-}
-
-RigidBody::~RigidBody() {
-    // Unique pointers automatically manage memory, so no need for manual deletion
+    inverseInertiaLocal = glm::inverse(inertiaTensor);
+    inverseInertiaTensor = inverseInertiaLocal;
+
+    friction = 0.3f;
+    spinFriction = 0.0f;
+    shape = CollisionShape{};
+    staticGeometry.reset();
+    continuousCollision = false;
+    sleeping = false;
+    sleepTimer = 0.0f;
+    sleepIsland = 0;
+
+    localBoxes.clear();
+    updateBoundingBoxes();
 }
 
 void RigidBody::applyForce(const glm::vec3& f) {
@@ -34,88 +55,103 @@ void RigidBody::applyTorque(const glm::vec3& t) {
     torque += t;
 }
 
+void RigidBody::interpolate(float alpha) {
+    renderPosition = glm::mix(previousPosition, position, alpha);
+    renderOrientation = glm::slerp(previousOrientation, orientation, alpha);
+}
+
 void RigidBody::updateInertiaTensor() {
     glm::mat3 rotationMatrix = glm::mat3_cast(orientation);
-    inverseInertiaTensor = rotationMatrix * glm::inverse(inertiaTensor) * glm::transpose(rotationMatrix);
+    inverseInertiaTensor = rotationMatrix * inverseInertiaLocal * glm::transpose(rotationMatrix);
 }
 
 void RigidBody::updateBoundingBoxes() {
-    // Update each bounding box based on the new position and orientation
-    for (auto box : boundingBoxes) {
-        box->update(position, orientation);
-//        aggregateBoundingBox.expandToInclude(*box);
+    if (staticGeometry) {
+        aggregateBoundingBox = staticGeometry->getBounds();
+        return;
+    }
+
+    // Bodies without boxes collapse to their position so the broadphase still has something to sort
+    aggregateBoundingBox = localBoxes.empty() ? BoundingBox(position, position) : BoundingBox();
+
+    // The aggregate is grown in the same pass that refits the boxes, so it never costs a second scan
+    boundingBoxes.resize(localBoxes.size());
+    if (orientation == glm::quat(1.0f, 0.0f, 0.0f, 0.0f)) {
+        // Unrotated bodies, which includes all static geometry, just move their boxes
+        for (size_t i = 0; i < localBoxes.size(); ++i) {
+            boundingBoxes[i] = BoundingBox(localBoxes[i].min + position, localBoxes[i].max + position);
+            aggregateBoundingBox.expandToInclude(boundingBoxes[i]);
+        }
+    } else {
+        glm::mat3 rotation = glm::mat3_cast(orientation);
+        for (size_t i = 0; i < localBoxes.size(); ++i) {
+            boundingBoxes[i] = localBoxes[i].transformed(position, rotation);
+            aggregateBoundingBox.expandToInclude(boundingBoxes[i]);
+        }
     }
+    boxSet.assign(boundingBoxes);
 }
 
+void RigidBody::setStaticGeometry(std::shared_ptr<const StaticGeometry> geometry) {
+    staticGeometry = std::move(geometry);
+    localBoxes.clear();
+    boundingBoxes.clear();
+    boxSet.clear();
+    if (staticGeometry) {
+        position = previousPosition = renderPosition = staticGeometry->getPosition();
+    }
+    updateBoundingBoxes();
+}
 
 void RigidBody::update(float deltaTime) {
+    if (mass == FLT_MAX) return;
+
+    previousPosition = position;
+    previousOrientation = orientation;
+
     // Linear dynamics
     acceleration = force / mass;
     velocity += acceleration * deltaTime;
     position += velocity * deltaTime;
     force = glm::vec3(0.0f);  // Reset force
 
-    // Angular dynamics
-//    glm::vec3 angularAcceleration = inverseInertiaTensor * torque;
-//    angularVelocity += angularAcceleration * deltaTime;
-//    orientation += glm::quat(0.0f, angularVelocity * deltaTime) * orientation * 0.5f;
-//    orientation = glm::normalize(orientation);
-//    torque = glm::vec3(0.0f);  // Reset torque
-//    updateInertiaTensor();
+    integrateAngular(deltaTime);
 
     // Update bounding boxes
     updateBoundingBoxes();
 }
 
-
-void RigidBody::setupBuffers() {
-    // Vertex coordinates for the bounding box based on min and max points
-    glm::vec3 &min = aggregateBoundingBox.min;
-    glm::vec3 &max = aggregateBoundingBox.max;
-    float vertices[] = {
-            // Positions        // Normals         // Texture Coords  // Colors (RGB)
-            min.x, min.y, min.z, 0.0, 0.0, -1.0,    0.0, 0.0,         1.0, 0.0, 0.0, // Min corner, red
-            max.x, min.y, min.z, 1.0, 0.0, 0.0,     1.0, 0.0,         0.0, 1.0, 0.0, // Max x, green
-            max.x, max.y, min.z, 0.0, 1.0, 0.0,     1.0, 1.0,         0.0, 0.0, 1.0, // Max x,y, blue
-            min.x, max.y, min.z, -1.0, 0.0, 0.0,    0.0, 1.0,         1.0, 1.0, 0.0, // Max y, yellow
-            min.x, min.y, max.z, 0.0, -1.0, 0.0,    0.0, 0.0,         1.0, 0.0, 1.0, // Max z, magenta
-            max.x, min.y, max.z, 1.0, 0.0, 0.0,     1.0, 0.0,         0.0, 1.0, 1.0, // Max x,z, cyan
-            max.x, max.y, max.z, 0.0, 1.0, 0.0,     1.0, 1.0,         1.0, 0.5, 0.0, // Max x,y,z, orange
-            min.x, max.y, max.z, -1.0, 0.0, 0.0,    0.0, 1.0,         0.5, 0.5, 0.5  // Max y,z, grey
-    };
-
-    unsigned int indices[] = {
-            0, 1, 1, 2, 2, 3, 3, 0,  // Bottom face
-            4, 5, 5, 6, 6, 7, 7, 4,  // Top face
-            0, 4, 1, 5, 2, 6, 3, 7   // Connecting edges
+void RigidBody::integrateAngular(float deltaTime) {
+    if (angularVelocity == glm::vec3(0.0f) && torque == glm::vec3(0.0f)) return;
+
+    // Gyroscopic term w x Iw, integrated implicitly in the body frame with one Newton step on
+    // I (w' - w) + dt w' x I w' = 0. The explicit form gains energy at high spin; this one does not.
+    glm::mat3 rotation = glm::mat3_cast(orientation);
+    glm::vec3 omega = glm::transpose(rotation) * angularVelocity;
+    glm::vec3 momentum = inertiaTensor * omega;
+    glm::vec3 residual = deltaTime * glm::cross(omega, momentum);
+    auto skew = [](const glm::vec3& v) {
+        return glm::mat3(0.0f, v.z, -v.y,
+                         -v.z, 0.0f, v.x,
+                         v.y, -v.x, 0.0f);
     };
-
-    std::cout << "Generated VAO: " << VAO << std::endl;
-    ::setupBuffers(VAO, VBO, EBO, vertices, sizeof(vertices), indices, sizeof(indices));
-    std::cout << "Generated VAO: " << VAO << std::endl;
-}
-
-
-void RigidBody::renderDebug(ShaderProgram &shader, const glm::vec3 &viewPos) {
-    glm::vec3 &min = aggregateBoundingBox.min;
-    glm::vec3 &max = aggregateBoundingBox.max;
-    shader.use();
-
-    // Set shader uniforms
-    shader.setUniformMat4("model", glm::mat4(1.0f));
-    shader.setUniformVec3("view", viewPos);
-    shader.setUniformVec3("objectColor", glm::vec3(1.0f, 1.0f, 1.0f));
-
-    // Check if VAO is valid
-    std::cout << "VAO: " << VAO << std::endl;
-
-    // Check for any previous OpenGL errors
-    GLenum error;
-    while ((error = glGetError()) != GL_NO_ERROR) {
-        std::cerr << "OpenGL error before glBindVertexArray: " << error << std::endl;
+    glm::mat3 jacobian = inertiaTensor + deltaTime * (skew(omega) * inertiaTensor - skew(momentum));
+    omega -= glm::inverse(jacobian) * residual;
+    angularVelocity = rotation * omega;
+
+    // External torque and tip friction
+    angularVelocity += inverseInertiaTensor * torque * deltaTime;
+    torque = glm::vec3(0.0f);
+    if (spinFriction > 0.0f) {
+        float speed = glm::length(angularVelocity);
+        float reduction = spinFriction * deltaTime;
+        angularVelocity = speed > reduction ? angularVelocity * ((speed - reduction) / speed) : glm::vec3(0.0f);
     }
 
-    GL_CHECK(glBindVertexArray(VAO));
-    GL_CHECK(glDrawElements(GL_LINES, 24, GL_UNSIGNED_INT, nullptr)); // 24 is the number of indices for 12 lines
-    GL_CHECK(glBindVertexArray(0));
+    // Exact rotation by |w| dt about w, so fast spin does not distort the quaternion
+    float speed = glm::length(angularVelocity);
+    if (speed > 0.0f) {
+        orientation = glm::normalize(glm::angleAxis(speed * deltaTime, angularVelocity / speed) * orientation);
+    }
+    updateInertiaTensor();
 }
@@ -6,49 +6,78 @@
 #include <glm/gtx/quaternion.hpp>
 #include <vector>
 #include <memory>
+#include <cfloat>
 #include "BoundingBox.h"
-#include "Utils.h"
+#include "BVH.h"
+#include "BoundingBoxSoA.h"
+#include "StaticGeometry.h"
 
 class RigidBody {
 public:
+    uint32_t id = 0;            // The body's pool slot in its world, reused once the body is destroyed
     glm::vec3 position;
     glm::vec3 velocity;
     glm::vec3 acceleration;
-    std::vector<BoundingBox*> boundingBoxes;
+    std::vector<BoundingBox> localBoxes;     // Collision boxes relative to position and orientation
+    std::vector<BoundingBox> boundingBoxes;  // localBoxes in world space, refit by updateBoundingBoxes
+    BoundingBoxSoA boxSet;            // Copy of boundingBoxes laid out for the SIMD overlap kernels
     float mass;
     glm::vec3 force;
     glm::vec3 angularVelocity;  // Angular velocity vector
     glm::vec3 torque;           // Accumulated torque
     glm::quat orientation;      // Orientation quaternion
+    glm::vec3 previousPosition;         // State at the start of the last step, for render interpolation
+    glm::quat previousOrientation;
+    glm::vec3 renderPosition;           // Interpolated between the previous and current state
+    glm::quat renderOrientation;
     glm::mat3 inertiaTensor;    // Inertia tensor in the body frame
+    glm::mat3 inverseInertiaLocal;  // Inverse inertia tensor in the body frame, computed once
     glm::mat3 inverseInertiaTensor; // Inverse inertia tensor in the world frame
-    BoundingBox aggregateBoundingBox; // Aggregate bounding box
+    float friction = 0.3f;      // Coulomb coefficient, combined with the other body's as sqrt(a * b)
+    float spinFriction = 0.0f;  // Constant angular deceleration against the spin, in rad/s^2 (tip friction)
+    BoundingBox aggregateBoundingBox; // Union of boundingBoxes, what the broadphase and midphase test first
+    CollisionShape shape;             // Used against analytic colliders instead of the boxes
+    std::shared_ptr<const StaticGeometry> staticGeometry;  // Shared boxes and collider of an immovable body
+    bool continuousCollision = false; // Swept against everything it could reach each step, for fast movers
+    bool sleeping = false;            // Skipped by integration and collision until something touches or moves it
+    float sleepTimer = 0.0f;          // Seconds spent below the world's sleep energy
+    uint32_t sleepIsland = 0;         // Island the body fell asleep with, so the whole island wakes together
 
-    RigidBody(const glm::vec3& pos, const glm::vec3& sz, float mass, std::vector<BoundingBox*> bboxes = {});
-    virtual ~RigidBody(); // Destructor to manage memory
+    RigidBody();
+    // bboxes are in body space
+    RigidBody(const glm::vec3& pos, const glm::vec3& sz, float mass, std::vector<BoundingBox> bboxes = {});
+
+    // Back to a freshly constructed state with no boxes. The box list keeps its capacity, so pooled bodies can
+    // be reused without reallocating. A mass of FLT_MAX makes the body immovable.
+    void reset(const glm::vec3& pos, const glm::vec3& sz, float bodyMass);
 
     void applyForce(const glm::vec3& f);
     void applyTorque(const glm::vec3& t);
+    void interpolate(float alpha);
 
-    virtual void update(float deltaTime);
-
-    void setupBuffers();
-    void renderDebug(ShaderProgram &shader, const glm::vec3 &viewPos);
+    void update(float deltaTime);  // Does nothing for immovable bodies
 
-    void updateBoundingBoxes();
 
-private:
-    void updateInertiaTensor();
+    void updateBoundingBoxes();  // Refits boundingBoxes, boxSet and aggregateBoundingBox to the current pose
+    // Collides with the shared geometry instead of boxes of its own, which are cleared. Moves the body to the
+    // geometry's position; it must be immovable and stay there.
+    void setStaticGeometry(std::shared_ptr<const StaticGeometry> geometry);
 
-    GLuint VAO, VBO, EBO;
-};
+    // What collision tests read: the static geometry's boxes when the body has some, its own otherwise
+    [[nodiscard]] const std::vector<BoundingBox>& getCollisionBoxes() const {
+        return staticGeometry ? staticGeometry->getBoxes() : boundingBoxes;
+    }
+    [[nodiscard]] const BoundingBoxSoA& getCollisionBoxSet() const {
+        return staticGeometry ? staticGeometry->getBoxSet() : boxSet;
+    }
+    // Tree over getCollisionBoxes, nullptr when they are few enough to scan
+    [[nodiscard]] const BVH* getBoxTree() const { return staticGeometry ? staticGeometry->getTree() : nullptr; }
+    [[nodiscard]] const StadiumCollider* getStadiumCollider() const {
+        return staticGeometry ? staticGeometry->getStadiumCollider() : nullptr;
+    }
 
-class ImmovableRigidBody : public RigidBody {
-public:
-    ImmovableRigidBody(const glm::vec3& pos, const glm::vec3& sz, std::vector<BoundingBox*> bboxes = {})
-            : RigidBody(pos, sz, FLT_MAX, std::move(bboxes)) {} // Infinite mass for immovable body
+    void updateInertiaTensor();  // Call after changing inertiaTensor or inverseInertiaLocal
 
-    void update(float deltaTime) override {
-        // No dynamics update for immovable bodies
-    }
+private:
+    void integrateAngular(float deltaTime);
 };
@@ -0,0 +1,160 @@
+#include <chrono>
+#include <cstring>
+#include "RollbackSession.h"
+
+namespace {
+    constexpr uint32_t kNone = UINT32_MAX;
+    constexpr uint32_t kMaxPacketInputs = 32;
+
+    // Packet layout: PacketHeader, then inputCount input bytes for frames firstFrame onwards
+    struct PacketHeader {
+        uint32_t firstFrame;
+        uint32_t ack;            // The sender has the receiver's inputs for every frame before this
+        uint32_t checksumFrame;  // kNone when the sender has no confirmed frame yet
+        uint64_t checksum;
+        uint8_t inputCount;
+    };
+}
+
+RollbackSession::RollbackSession(Match& match, int localPlayer, Transport& transport, const RollbackSettings& settings)
+        : match(match), localPlayer(localPlayer), transport(transport), settings(settings), history(kHistory) {
+    // The peer can run up to inputDelay + maxPrediction frames ahead and we can roll back maxPrediction,
+    // all of which has to fit in the history
+    this->settings.inputDelay = std::min(this->settings.inputDelay, 8u);
+    this->settings.maxPrediction = std::max(1u, std::min(this->settings.maxPrediction, 16u));
+    this->settings.stepsPerFrame = std::max(1u, this->settings.stepsPerFrame);
+
+    // Nobody has input for the first inputDelay frames, so both sides already agree on them
+    localScheduled = this->settings.inputDelay;
+    remoteConfirmed = this->settings.inputDelay;
+    peerConfirmed = this->settings.inputDelay;
+}
+
+bool RollbackSession::advanceFrame(PlayerInput localInput) {
+    receiveInputs();
+
+    if (rollbackFrame != kNone) {
+        auto start = std::chrono::steady_clock::now();
+        uint32_t from = rollbackFrame;
+        match.restore(history[from % kHistory].state);
+        for (uint32_t f = from; f < frame; ++f) {
+            simulate(f);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats.rollbacks++;
+        stats.resimulatedFrames += frame - from;
+        stats.maxRollbackFrames = std::max(stats.maxRollbackFrames, frame - from);
+        stats.rollbackSeconds += seconds;
+        stats.maxRollbackSeconds = std::max(stats.maxRollbackSeconds, seconds);
+        rollbackFrame = kNone;
+    }
+    checkPeerChecksum();
+
+    // Stop predicting once it could not be rolled back, or once inputs the peer has not acknowledged would
+    // drop out of the resend window
+    bool predictable = frame < remoteConfirmed + settings.maxPrediction;
+    bool resendable = localScheduled + 1 - peerConfirmed <= kHistory;
+    if (!predictable || !resendable) {
+        stats.stalledFrames++;
+        sendInputs();
+        return false;
+    }
+
+    localInputs[localScheduled % kHistory] = localInput;
+    localScheduled++;
+    sendInputs();
+    simulate(frame);
+    frame++;
+    return true;
+}
+
+bool RollbackSession::getChecksum(uint32_t frameIndex, uint64_t& checksum) const {
+    if (frameIndex >= frame || frameIndex > remoteConfirmed || frameIndex + kHistory < frame) return false;
+    checksum = history[frameIndex % kHistory].checksum;
+    return true;
+}
+
+void RollbackSession::sendInputs() {
+    PacketHeader header{};
+    header.firstFrame = peerConfirmed;
+    header.ack = remoteConfirmed;
+    header.inputCount = static_cast<uint8_t>(std::min(localScheduled - peerConfirmed, kMaxPacketInputs));
+    header.checksumFrame = kNone;
+    if (frame > 0) {
+        uint32_t confirmed = std::min(remoteConfirmed, frame - 1);
+        if (getChecksum(confirmed, header.checksum)) header.checksumFrame = confirmed;
+    }
+
+    packet.resize(sizeof(header) + header.inputCount);
+    std::memcpy(packet.data(), &header, sizeof(header));
+    for (uint32_t i = 0; i < header.inputCount; ++i) {
+        packet[sizeof(header) + i] = localInputs[(header.firstFrame + i) % kHistory].buttons;
+    }
+    transport.send(packet.data(), packet.size());
+    stats.packetsSent++;
+}
+
+void RollbackSession::receiveInputs() {
+    int remotePlayer = 1 - localPlayer;
+    while (transport.receive(packet)) {
+        PacketHeader header{};
+        if (packet.size() < sizeof(header)) continue;
+        std::memcpy(&header, packet.data(), sizeof(header));
+        if (packet.size() < sizeof(header) + header.inputCount) continue;
+        stats.packetsReceived++;
+
+        // Acks only ever move forward; an old packet arriving late says nothing new
+        peerConfirmed = std::max(peerConfirmed, std::min(header.ack, localScheduled));
+
+        for (uint32_t i = 0; i < header.inputCount; ++i) {
+            uint32_t f = header.firstFrame + i;
+            if (f < remoteConfirmed) continue;
+            // Inputs are only taken in order, and never so far ahead that they would overwrite ones still needed
+            if (f > remoteConfirmed || f >= frame + kHistory - settings.maxPrediction) break;
+
+            PlayerInput input{packet[sizeof(header) + i]};
+            remoteInputs[f % kHistory] = input;
+            remoteConfirmed++;
+            if (f < frame && history[f % kHistory].inputs[remotePlayer] != input) {
+                rollbackFrame = std::min(rollbackFrame, f);
+            }
+        }
+
+        if (header.checksumFrame != kNone && (peerChecksumFrame == kNone || header.checksumFrame > peerChecksumFrame)) {
+            peerChecksumFrame = header.checksumFrame;
+            peerChecksum = header.checksum;
+        }
+    }
+}
+
+void RollbackSession::checkPeerChecksum() {
+    if (peerChecksumFrame == kNone) return;
+    uint64_t checksum;
+    if (getChecksum(peerChecksumFrame, checksum)) {
+        if (checksum != peerChecksum) stats.desyncFrame = std::min(stats.desyncFrame, peerChecksumFrame);
+        peerChecksumFrame = kNone;
+    } else if (peerChecksumFrame + kHistory < frame) {
+        // Fell out of the history before it was confirmed here
+        peerChecksumFrame = kNone;
+    }
+}
+
+PlayerInput RollbackSession::remoteInputFor(uint32_t frameIndex) const {
+    if (frameIndex < remoteConfirmed) return remoteInputs[frameIndex % kHistory];
+    // Predict that the remote player is still holding whatever they held last
+    return remoteConfirmed > 0 ? remoteInputs[(remoteConfirmed - 1) % kHistory] : PlayerInput{};
+}
+
+void RollbackSession::simulate(uint32_t frameIndex) {
+    FrameRecord& record = history[frameIndex % kHistory];
+    match.snapshot(record.state);
+    record.checksum = worldChecksum(match.getWorld());
+    record.inputs[localPlayer] = localInputs[frameIndex % kHistory];
+    record.inputs[1 - localPlayer] = remoteInputFor(frameIndex);
+
+    match.setInput(0, record.inputs[0]);
+    match.setInput(1, record.inputs[1]);
+    for (uint32_t i = 0; i < settings.stepsPerFrame; ++i) {
+        match.step();
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "Match.h"
+#include "Transport.h"
+
+// Two-player netcode with input delay and rollback. Each peer runs the whole match. Local inputs take effect
+// inputDelay frames after they are read and are sent to the other peer. Until the remote player's input for a
+// frame arrives, it is predicted to be the same as their last known one. When an input arrives that differs
+// from its prediction, the match is restored to the frame it belongs to and every frame since is simulated
+// again. Both peers end up running every frame on the same inputs, so they stay in lockstep.
+
+struct RollbackSettings {
+    uint32_t inputDelay = 2;     // Frames between reading a local input and it taking effect
+    uint32_t maxPrediction = 8;  // Frames the session may run past the last confirmed remote input
+    uint32_t stepsPerFrame = 4;  // Match steps per frame, 240 Hz physics at 60 frames per second
+};
+
+struct RollbackStats {
+    uint32_t rollbacks = 0;
+    uint32_t resimulatedFrames = 0;
+    uint32_t maxRollbackFrames = 0;
+    uint32_t stalledFrames = 0;  // Calls to advanceFrame that waited on the remote player instead
+    double rollbackSeconds = 0.0;
+    double maxRollbackSeconds = 0.0;
+    uint32_t packetsSent = 0;
+    uint32_t packetsReceived = 0;
+    uint32_t desyncFrame = UINT32_MAX;  // First frame whose checksum differed between the peers
+};
+
+class RollbackSession {
+public:
+    // Frames are kept for rollback in a ring this long, which bounds inputDelay + maxPrediction
+    static constexpr uint32_t kHistory = 64;
+
+    // The match must be in the same starting state on both peers. It is stepped only by the session.
+    RollbackSession(Match& match, int localPlayer, Transport& transport, const RollbackSettings& settings);
+
+    // Sends and receives inputs, rolls back if a remote input arrived that differs from its prediction, then
+    // simulates one frame. localInput takes effect at frame getFrame() + inputDelay. Returns false, without
+    // simulating or using localInput, while the remote player is too far behind to keep predicting.
+    bool advanceFrame(PlayerInput localInput);
+
+    // Frames simulated so far; the match is at the start of this frame
+    [[nodiscard]] uint32_t getFrame() const { return frame; }
+    // Frames before this one were simulated with confirmed inputs only and will not be rolled back
+    [[nodiscard]] uint32_t getConfirmedFrame() const { return std::min(remoteConfirmed, frame); }
+    // Checksum of the world at the start of a confirmed frame still in the history, for comparing peers
+    bool getChecksum(uint32_t frameIndex, uint64_t& checksum) const;
+    [[nodiscard]] const RollbackStats& getStats() const { return stats; }
+
+private:
+    struct FrameRecord {
+        PlayerInput inputs[2];      // What the frame was last simulated with, predictions included
+        MatchSnapshot state;        // At the start of the frame
+        uint64_t checksum = 0;      // Of state
+    };
+
+    Match& match;
+    int localPlayer;
+    Transport& transport;
+    RollbackSettings settings;
+    RollbackStats stats;
+
+    std::vector<FrameRecord> history;  // Indexed by frame % kHistory
+    PlayerInput localInputs[kHistory];
+    PlayerInput remoteInputs[kHistory];
+    uint32_t frame = 0;
+    uint32_t localScheduled = 0;   // Local inputs are known for every frame before this
+    uint32_t remoteConfirmed = 0;  // Remote inputs are known for every frame before this
+    uint32_t peerConfirmed = 0;    // The peer has acknowledged our inputs for every frame before this
+    uint32_t rollbackFrame = UINT32_MAX;
+    uint32_t peerChecksumFrame = UINT32_MAX;  // Last checksum the peer reported, not yet compared
+    uint64_t peerChecksum = 0;
+    std::vector<uint8_t> packet;
+
+    void sendInputs();
+    void receiveInputs();
+    void checkPeerChecksum();
+    [[nodiscard]] PlayerInput remoteInputFor(uint32_t frameIndex) const;
+    void simulate(uint32_t frameIndex);
+};
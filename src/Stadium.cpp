@@ -5,8 +5,8 @@ Stadium::Stadium(unsigned int vao, unsigned int vbo, unsigned int ebo, const glm
                  int verticesPerRing, Texture* texture, float textureScale, PhysicsWorld* physicsWorld)
         : GameObject(vao, vbo, ebo, pos, col), ringColor(ringColor), crossColor(crossColor), radius(radius), curvature(curvature),
           numRings(numRings), verticesPerRing(verticesPerRing), texture(texture), textureScale(textureScale), physicsWorld(physicsWorld) {
-    body = new ImmovableRigidBody(pos, glm::vec3(radius * 2.0f, curvature * radius * radius, radius * 2.0f));
-    physicsWorld->addBody(body);
+    body = physicsWorld->getBody(physicsWorld->createImmovableBody(pos, glm::vec3(radius * 2.0f, curvature * radius * radius, radius * 2.0f)));
+    name = "Stadium";
     Stadium::initializeMesh();
     std::cout << "Stadium color: (" << color.x << ", " << color.y << ", " << color.z << ")\n";
 }
@@ -19,27 +19,24 @@ void Stadium::generateMeshData() {
     texCoords.clear();
     indices.clear();
     tangents.clear();
+    colors.clear();
 
-    // Add center vertex first
-    vertices.emplace_back(0, 0, 0);
-    texCoords.emplace_back(0.5, 0.5);
-    colors.emplace_back(crossColor);
-
-    if(verticesPerRing % 4 != 0) {
-        std::cerr << "Vertices per ring must be a multiple of 4" << std::endl;
+    StadiumGeometry geometry;
+    if (!geometry.generate(radius, curvature, numRings, verticesPerRing)) {
         return;
     }
+    vertices = geometry.vertices;
+    indices = geometry.indices;
 
-    // Generate vertices
+    // Center vertex
+    texCoords.emplace_back(0.5, 0.5);
+    colors.emplace_back(crossColor);
+
+    // Texture coordinates and colors follow the generator's ring-major vertex order
     for (int rIdx = 1; rIdx <= numRings; ++rIdx) {
         float r = pow(static_cast<float>(rIdx) / numRings, 0.5) * radius;
         for (int thetaIdx = 0; thetaIdx < verticesPerRing; ++thetaIdx) {
             float theta = 2.0f * M_PI * static_cast<float>(thetaIdx) / static_cast<float>(verticesPerRing);
-            float x = r * std::cos(theta);
-            float z = r * std::sin(theta); // Change y to z
-            float y = std::pow(r, 2.0f) * curvature; // Use r for y calculation
-
-            vertices.emplace_back(x, y, z);
             texCoords.emplace_back(textureScale * (r / radius * std::cos(theta)) + 0.5f,
                                    textureScale * (r / radius * std::sin(theta)) + 0.5f);
             // Set ring color for middle and end
@@ -50,119 +47,31 @@ void Stadium::generateMeshData() {
             } else {
                 colors.emplace_back(color);
             }
-//            // Create a spiral color pattern
-//            if ((rIdx + thetaIdx * 2) % (verticesPerRing / 2) < verticesPerRing / (numRings / 2)) {
-//                colors.emplace_back(ringColor);
-//            } else if (thetaIdx % (verticesPerRing / 12) == 0) {
-//                colors.emplace_back(crossColor);
-//            } else {
-//                colors.emplace_back(color);
-//            }
         }
     }
 
     normals.resize(vertices.size(), glm::vec3(0.0f));
     tangents.resize(vertices.size(), glm::vec3(0.0f));
 
-    // Draw from origin to first ring
-    for (int i = 0; i < verticesPerRing; ++i) {
-        int origin = 0;
-        int curr = i + 1;
-        int next = (i + 1) % verticesPerRing + 1;
-        indices.push_back(origin);
-        indices.push_back(curr);
-        indices.push_back(next);
-        glm::vec3 v0 = vertices[origin];
-        glm::vec3 v1 = vertices[curr];
-        glm::vec3 v2 = vertices[next];
-        glm::vec3 edge1 = v1 - v0;
-        glm::vec3 edge2 = v2 - v0;
+    // Accumulate face normals and tangents onto each triangle's vertices
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        unsigned int i0 = indices[i];
+        unsigned int i1 = indices[i + 1];
+        unsigned int i2 = indices[i + 2];
+        glm::vec3 edge1 = vertices[i1] - vertices[i0];
+        glm::vec3 edge2 = vertices[i2] - vertices[i0];
         glm::vec3 normal = glm::normalize(glm::cross(edge1, edge2));
-        normals[origin] += normal;
-        normals[curr] += normal;
-        normals[next] += normal;
-        // Calculate tangent for the triangle
-        glm::vec2 uv0 = texCoords[origin];
-        glm::vec2 uv1 = texCoords[curr];
-        glm::vec2 uv2 = texCoords[next];
-        glm::vec2 deltaUV1 = uv1 - uv0;
-        glm::vec2 deltaUV2 = uv2 - uv0;
+        normals[i0] += normal;
+        normals[i1] += normal;
+        normals[i2] += normal;
+
+        glm::vec2 deltaUV1 = texCoords[i1] - texCoords[i0];
+        glm::vec2 deltaUV2 = texCoords[i2] - texCoords[i0];
         float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
         glm::vec3 tangent = f * (deltaUV2.y * edge1 - deltaUV1.y * edge2);
-        tangents[origin] += tangent;
-        tangents[curr] += tangent;
-        tangents[next] += tangent;
-    }
-
-    // Do pairs starting from (1, 2) to (n-1, n)
-    for (int rIdx = 1; rIdx < numRings; ++rIdx) {
-        int offset1 = (rIdx - 1) * verticesPerRing + 1;
-        int offset2 = rIdx * verticesPerRing + 1;
-
-        for (int vertIdx = 0; vertIdx < verticesPerRing; ++vertIdx) {
-            int curr1 = offset1 + vertIdx;
-            int next1 = offset1 + (vertIdx + 1) % verticesPerRing;
-            int curr2 = offset2 + vertIdx;
-            int next2 = offset2 + (vertIdx + 1) % verticesPerRing;
-
-            // Triangle 1: (curr1, curr2, next1)
-            indices.push_back(curr1);
-            indices.push_back(curr2);
-            indices.push_back(next1);
-
-            // Calculate normal for Triangle 1
-            glm::vec3 v0 = vertices[curr1];
-            glm::vec3 v1 = vertices[curr2];
-            glm::vec3 v2 = vertices[next1];
-            glm::vec3 edge1 = v1 - v0;
-            glm::vec3 edge2 = v2 - v0;
-            glm::vec3 normal = glm::normalize(glm::cross(edge1, edge2));
-
-            normals[curr1] += normal;
-            normals[curr2] += normal;
-            normals[next1] += normal;
-
-            // Calculate tangent for Triangle 1
-            glm::vec2 uv0 = texCoords[curr1];
-            glm::vec2 uv1 = texCoords[curr2];
-            glm::vec2 uv2 = texCoords[next1];
-            glm::vec2 deltaUV1 = uv1 - uv0;
-            glm::vec2 deltaUV2 = uv2 - uv0;
-            float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-            glm::vec3 tangent = f * (deltaUV2.y * edge1 - deltaUV1.y * edge2);
-            tangents[curr1] += tangent;
-            tangents[curr2] += tangent;
-            tangents[next1] += tangent;
-
-            // Triangle 2: (next1, curr2, next2)
-            indices.push_back(next1);
-            indices.push_back(curr2);
-            indices.push_back(next2);
-
-            // Calculate normal for Triangle 2
-            v0 = vertices[next1];
-            v1 = vertices[curr2];
-            v2 = vertices[next2];
-            edge1 = v1 - v0;
-            edge2 = v2 - v0;
-            normal = glm::normalize(glm::cross(edge1, edge2));
-
-            normals[next1] += normal;
-            normals[curr2] += normal;
-            normals[next2] += normal;
-
-            // Calculate tangent for Triangle 2
-            uv0 = texCoords[next1];
-            uv1 = texCoords[curr2];
-            uv2 = texCoords[next2];
-            deltaUV1 = uv1 - uv0;
-            deltaUV2 = uv2 - uv0;
-            f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-            tangent = f * (deltaUV2.y * edge1 - deltaUV1.y * edge2);
-            tangents[next1] += tangent;
-            tangents[curr2] += tangent;
-            tangents[next2] += tangent;
-        }
+        tangents[i0] += tangent;
+        tangents[i1] += tangent;
+        tangents[i2] += tangent;
     }
 
     for (auto &normal: normals) {
@@ -172,18 +81,8 @@ void Stadium::generateMeshData() {
         tangent = glm::normalize(tangent);
     }
 
-    // Calculate bounding boxes for each triangle
-    for (size_t i = 0; i < indices.size(); i += 3) {
-        glm::vec3 v1 = vertices[indices[i]];
-        glm::vec3 v2 = vertices[indices[i + 1]];
-        glm::vec3 v3 = vertices[indices[i + 2]];
-
-        auto bbox = new BoundingBox();
-        bbox->update(v1, v2, v3);
-
-        // Add the bounding box to the immovable rigid body
-        body->boundingBoxes.push_back(bbox);
-    }
+    // Tops collide with the exact bowl, the triangle boxes are for everything without a shape (the camera)
+    body->setStaticGeometry(geometry.createStaticGeometry(position, std::make_shared<StadiumCollider>(position, radius, curvature)));
 
 //    // Print out the vertices
 //    std::cout << "Vertices: " << vertices.size() << std::endl;
@@ -220,6 +119,7 @@ void Stadium::generateMeshData() {
 
 void Stadium::initializeMesh() {
     generateMeshData();
+    pickTree.build(vertices, indices);
     if (vertices.size() != normals.size() || vertices.size() != texCoords.size()) {
         std::cerr << "Mesh data is inconsistent" << std::endl;
         std::cout << "Vertices: " << vertices.size() << ", Normals: " << normals.size() << ", TexCoords: "
@@ -6,6 +6,7 @@
 #include "Buffers.h"
 #include "BoundingBox.h"
 #include "PhysicsWorld.h"
+#include "StadiumGeometry.h"
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <vector>
@@ -26,7 +27,7 @@ public:
     void initializeMesh() override;
     void render(ShaderProgram &shader, const glm::vec3 &lightColor, const glm::vec3 &lightPos) override;
 
-    ImmovableRigidBody* body;
+    RigidBody* body;  // Owned by physicsWorld
 protected:
     void generateMeshData();
 
@@ -40,7 +41,5 @@ private:
     glm::vec3 ringColor;
     glm::vec3 crossColor;
 
-    std::vector<std::unique_ptr<BoundingBox>> triangleBoundingBoxes;
-
     float textureScale = 1.0f;
 };
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <cmath>
+#include "StadiumCollider.h"
+
+namespace {
+    constexpr float kEpsilon = 1e-6f;
+}
+
+StadiumCollider::StadiumCollider(const glm::vec3& position, float radius, float curvature)
+        : position(position), radius(radius), curvature(curvature) {}
+
+float StadiumCollider::closestRadius(float rho, float y) const {
+    if (std::abs(curvature) < kEpsilon) return rho;
+
+    // Setting the derivative of the squared distance to zero gives 2c^2 r^3 + (1 - 2cy) r - rho = 0,
+    // solved in depressed form r^3 + p r + q = 0. Doubles keep the cancellation in Cardano's formula harmless.
+    double c = curvature;
+    double a = 2.0 * c * c;
+    double p = (1.0 - 2.0 * c * y) / a;
+    double q = -static_cast<double>(rho) / a;
+    double discriminant = q * q / 4.0 + p * p * p / 27.0;
+
+    double r;
+    if (discriminant >= 0.0) {
+        double s = std::sqrt(discriminant);
+        r = std::cbrt(-q / 2.0 + s) + std::cbrt(-q / 2.0 - s);
+    } else {
+        // Three real roots when the point is above the focus. The largest is the one on the point's side.
+        double m = 2.0 * std::sqrt(-p / 3.0);
+        double cosine = std::clamp(3.0 * q / (p * m), -1.0, 1.0);
+        r = m * std::cos(std::acos(cosine) / 3.0);
+    }
+    return static_cast<float>(std::max(r, 0.0));
+}
+
+glm::vec3 StadiumCollider::surfaceNormal(float r, const glm::vec2& dir) const {
+    float slope = 2.0f * curvature * r;
+    return glm::normalize(glm::vec3(-slope * dir.x, 1.0f, -slope * dir.y));
+}
+
+glm::vec3 StadiumCollider::closestPoint(const glm::vec3& point) const {
+    glm::vec3 local = point - position;
+    float rho = std::sqrt(local.x * local.x + local.z * local.z);
+    glm::vec2 dir = rho > kEpsilon ? glm::vec2(local.x, local.z) / rho : glm::vec2(1.0f, 0.0f);
+    float r = std::min(closestRadius(rho, local.y), radius);
+    return position + glm::vec3(dir.x * r, curvature * r * r, dir.y * r);
+}
+
+bool StadiumCollider::collidePoint(const glm::vec3& point, float pointRadius, StadiumContact& contact) const {
+    glm::vec3 local = point - position;
+    float rho = std::sqrt(local.x * local.x + local.z * local.z);
+    glm::vec2 dir = rho > kEpsilon ? glm::vec2(local.x, local.z) / rho : glm::vec2(1.0f, 0.0f);
+    float r = std::min(closestRadius(rho, local.y), radius);
+
+    contact.point = position + glm::vec3(dir.x * r, curvature * r * r, dir.y * r);
+    glm::vec3 offset = point - contact.point;
+    float distance = glm::length(offset);
+
+    // Under the surface and inside the rim: push straight out along the surface normal
+    if (rho <= radius && local.y < curvature * rho * rho) {
+        contact.normal = surfaceNormal(r, dir);
+        contact.depth = pointRadius + distance;
+        return true;
+    }
+
+    // Otherwise the normal is set even on a miss, so callers can use it as a search direction
+    contact.normal = distance > kEpsilon ? offset / distance : surfaceNormal(r, dir);
+    contact.depth = pointRadius - distance;
+    return contact.depth >= 0.0f;
+}
+
+bool StadiumCollider::collideSphere(const glm::vec3& center, float sphereRadius, StadiumContact& contact) const {
+    return collidePoint(center, sphereRadius, contact);
+}
+
+bool StadiumCollider::collideDisc(const glm::vec3& center, const glm::vec3& axis, float discRadius,
+                                  StadiumContact& contact) const {
+    // The disc point deepest along the contact normal is its edge point facing away from it. The normal depends
+    // on where that point is, so refine it twice; the bowl is smooth enough for that to settle.
+    StadiumContact candidate{};
+    collidePoint(center, 0.0f, candidate);
+    glm::vec3 normal = candidate.normal;
+    bool hit = false;
+    for (int i = 0; i < 2; ++i) {
+        glm::vec3 inPlane = normal - glm::dot(normal, axis) * axis;
+        float length = glm::length(inPlane);
+        glm::vec3 support = length > kEpsilon ? center - inPlane * (discRadius / length) : center;
+        hit = collidePoint(support, 0.0f, candidate);
+        normal = candidate.normal;
+    }
+    contact = candidate;
+    return hit;
+}
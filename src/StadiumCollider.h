@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Shape a body presents to analytic colliders. Discs lie in the plane perpendicular to the body's local up axis.
+enum class ShapeType {
+    None,    // Only the body's boxes collide
+    Sphere,
+    Disc
+};
+
+struct CollisionShape {
+    ShapeType type = ShapeType::None;
+    float radius = 0.0f;
+};
+
+struct StadiumContact {
+    glm::vec3 point;   // On the stadium surface
+    glm::vec3 normal;  // Out of the stadium, towards the other shape
+    float depth;       // Penetration along normal, positive when overlapping
+};
+
+// Exact collider for the stadium bowl y = curvature * r^2 (relative to position) for r up to radius, the same
+// surface Stadium triangulates. Contacts cost the same no matter how finely the mesh is tessellated.
+// The bowl is treated as solid below the surface, and the rim is the circular edge at r = radius.
+class StadiumCollider {
+public:
+    StadiumCollider(const glm::vec3& position, float radius, float curvature);
+
+    // Closest point on the bowl surface, including its rim edge
+    [[nodiscard]] glm::vec3 closestPoint(const glm::vec3& point) const;
+    // Unit surface normal at horizontal distance r from the centre along the unit direction dir
+    [[nodiscard]] glm::vec3 surfaceNormal(float r, const glm::vec2& dir) const;
+
+    // Both fill in contact even when they miss, with a negative depth, so it doubles as a signed distance
+    bool collideSphere(const glm::vec3& center, float sphereRadius, StadiumContact& contact) const;
+    bool collideDisc(const glm::vec3& center, const glm::vec3& axis, float discRadius, StadiumContact& contact) const;
+
+    [[nodiscard]] const glm::vec3& getPosition() const { return position; }
+    [[nodiscard]] float getRadius() const { return radius; }
+    [[nodiscard]] float getCurvature() const { return curvature; }
+
+private:
+    glm::vec3 position;
+    float radius;
+    float curvature;
+
+    // Radius of the closest surface point to a point at horizontal distance rho and local height y, before clamping
+    [[nodiscard]] float closestRadius(float rho, float y) const;
+    // Contact for a point with a radius. Returns false if it does not touch the bowl.
+    bool collidePoint(const glm::vec3& point, float pointRadius, StadiumContact& contact) const;
+};
@@ -0,0 +1,64 @@
+#include <cmath>
+#include <iostream>
+#include "StadiumGeometry.h"
+
+bool StadiumGeometry::generate(float radius_, float curvature_, int numRings_, int verticesPerRing_) {
+    radius = radius_;
+    curvature = curvature_;
+    numRings = numRings_;
+    verticesPerRing = verticesPerRing_;
+    vertices.clear();
+    indices.clear();
+
+    if (verticesPerRing % 4 != 0) {
+        std::cerr << "Vertices per ring must be a multiple of 4" << std::endl;
+        return false;
+    }
+
+    // Center vertex first
+    vertices.emplace_back(0, 0, 0);
+
+    // Rings are spaced by sqrt so every ring covers roughly the same area
+    for (int rIdx = 1; rIdx <= numRings; ++rIdx) {
+        float r = std::pow(static_cast<float>(rIdx) / numRings, 0.5) * radius;
+        for (int thetaIdx = 0; thetaIdx < verticesPerRing; ++thetaIdx) {
+            float theta = 2.0f * M_PI * static_cast<float>(thetaIdx) / static_cast<float>(verticesPerRing);
+            vertices.emplace_back(r * std::cos(theta), std::pow(r, 2.0f) * curvature, r * std::sin(theta));
+        }
+    }
+
+    // Fan from the center to the first ring
+    for (int i = 0; i < verticesPerRing; ++i) {
+        indices.push_back(0);
+        indices.push_back(i + 1);
+        indices.push_back((i + 1) % verticesPerRing + 1);
+    }
+
+    // Two triangles between each pair of neighbouring rings
+    for (int rIdx = 1; rIdx < numRings; ++rIdx) {
+        unsigned int offset1 = (rIdx - 1) * verticesPerRing + 1;
+        unsigned int offset2 = rIdx * verticesPerRing + 1;
+        for (int vertIdx = 0; vertIdx < verticesPerRing; ++vertIdx) {
+            unsigned int curr1 = offset1 + vertIdx;
+            unsigned int next1 = offset1 + (vertIdx + 1) % verticesPerRing;
+            unsigned int curr2 = offset2 + vertIdx;
+            unsigned int next2 = offset2 + (vertIdx + 1) % verticesPerRing;
+
+            indices.insert(indices.end(), {curr1, curr2, next1});
+            indices.insert(indices.end(), {next1, curr2, next2});
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<const StaticGeometry> StadiumGeometry::createStaticGeometry(
+        const glm::vec3& position, std::shared_ptr<const StadiumCollider> stadiumCollider) const {
+    std::vector<BoundingBox> boxes;
+    boxes.reserve(indices.size() / 3);
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        BoundingBox box;
+        box.update(vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]]);
+        boxes.push_back(box);
+    }
+    return StaticGeometry::create(position, boxes, true, std::move(stadiumCollider));
+}
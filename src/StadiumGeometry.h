@@ -0,0 +1,26 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "StaticGeometry.h"
+
+// Shape of the stadium bowl y = curvature * r^2, shared by the rendered Stadium and headless code.
+// Vertex 0 is the center, followed by numRings rings of verticesPerRing vertices each, innermost first.
+struct StadiumGeometry {
+    float radius;
+    float curvature;
+    int numRings;
+    int verticesPerRing;
+
+    std::vector<glm::vec3> vertices;
+    std::vector<unsigned int> indices;  // Three per triangle
+
+    // Returns false (and leaves the geometry empty) if verticesPerRing is not a multiple of 4
+    bool generate(float radius, float curvature, int numRings, int verticesPerRing);
+
+    // Collision for the bowl placed at position: one box per triangle under a tree, plus stadiumCollider if
+    // given, which shapes then collide with instead of the boxes
+    [[nodiscard]] std::shared_ptr<const StaticGeometry> createStaticGeometry(
+            const glm::vec3& position, std::shared_ptr<const StadiumCollider> stadiumCollider = nullptr) const;
+};
@@ -0,0 +1,30 @@
+#include "StaticGeometry.h"
+
+std::shared_ptr<const StaticGeometry> StaticGeometry::create(const glm::vec3& position,
+                                                             const std::vector<BoundingBox>& localBoxes,
+                                                             bool buildTree,
+                                                             std::shared_ptr<const StadiumCollider> stadiumCollider) {
+    auto geometry = std::shared_ptr<StaticGeometry>(new StaticGeometry());
+    geometry->position = position;
+    geometry->localBoxes = localBoxes;
+    geometry->stadiumCollider = std::move(stadiumCollider);
+
+    // Placed the same way RigidBody::updateBoundingBoxes places an unrotated body's boxes, so a body sharing
+    // the geometry collides exactly as one holding its own copy would
+    geometry->bounds = localBoxes.empty() ? BoundingBox(position, position) : BoundingBox();
+    geometry->boxes.reserve(localBoxes.size());
+    for (const BoundingBox& box : localBoxes) {
+        geometry->boxes.emplace_back(box.min + position, box.max + position);
+        geometry->bounds.expandToInclude(geometry->boxes.back());
+    }
+    geometry->boxSet.assign(geometry->boxes);
+    if (buildTree) {
+        geometry->tree.build(geometry->boxes);
+    }
+    return geometry;
+}
+
+size_t StaticGeometry::memoryBytes() const {
+    return (localBoxes.capacity() + boxes.capacity()) * sizeof(BoundingBox) +
+           6 * boxSet.minX.capacity() * sizeof(float) + tree.memoryBytes();
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "BoundingBox.h"
+#include "BoundingBoxSoA.h"
+#include "BVH.h"
+#include "StadiumCollider.h"
+
+// Collision data of immovable bodies, built once and never changed afterwards. Held through
+// std::shared_ptr<const StaticGeometry>, one copy serves any number of bodies in any number of worlds on any
+// thread, so a world holding only a stadium and its tops stores little more than the tops.
+// Boxes are kept in world space at the position the geometry was created for; bodies using it sit there.
+class StaticGeometry {
+public:
+    // localBoxes are relative to position. buildTree puts a tree over them for geometry with many boxes.
+    static std::shared_ptr<const StaticGeometry> create(const glm::vec3& position,
+                                                        const std::vector<BoundingBox>& localBoxes, bool buildTree,
+                                                        std::shared_ptr<const StadiumCollider> stadiumCollider = nullptr);
+
+    [[nodiscard]] const glm::vec3& getPosition() const { return position; }
+    [[nodiscard]] const std::vector<BoundingBox>& getLocalBoxes() const { return localBoxes; }
+    [[nodiscard]] const std::vector<BoundingBox>& getBoxes() const { return boxes; }
+    [[nodiscard]] const BoundingBoxSoA& getBoxSet() const { return boxSet; }
+    [[nodiscard]] const BVH* getTree() const { return tree.empty() ? nullptr : &tree; }
+    [[nodiscard]] const BoundingBox& getBounds() const { return bounds; }
+    [[nodiscard]] const StadiumCollider* getStadiumCollider() const { return stadiumCollider.get(); }
+
+    // Heap memory held by the boxes and tree, which is what sharing saves per world
+    [[nodiscard]] size_t memoryBytes() const;
+
+private:
+    glm::vec3 position{0.0f};
+    std::vector<BoundingBox> localBoxes;  // As given, kept so replays can store them exactly
+    std::vector<BoundingBox> boxes;       // World space
+    BoundingBoxSoA boxSet;
+    BVH tree;
+    BoundingBox bounds;
+    std::shared_ptr<const StadiumCollider> stadiumCollider;
+};
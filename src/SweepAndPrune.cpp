@@ -0,0 +1,96 @@
+#include <algorithm>
+#include "SweepAndPrune.h"
+
+void SweepAndPrune::addBody(RigidBody* body) {
+    const BoundingBox& bounds = body->aggregateBoundingBox;
+    proxies.push_back({body, bounds.min, bounds.max, true});
+    order.push_back(static_cast<uint32_t>(proxies.size() - 1));
+}
+
+void SweepAndPrune::removeBody(RigidBody* body) {
+    auto it = std::find_if(proxies.begin(), proxies.end(), [&](const Proxy& proxy) { return proxy.body == body; });
+    if (it == proxies.end()) return;
+    auto removed = static_cast<uint32_t>(it - proxies.begin());
+    proxies.erase(it);
+
+    // Drop the proxy from the sorted order and shift the indices of the ones after it
+    order.erase(std::remove(order.begin(), order.end(), removed), order.end());
+    for (uint32_t& index : order) {
+        if (index > removed) --index;
+    }
+}
+
+void SweepAndPrune::clear() {
+    proxies.clear();
+    order.clear();
+    pairs.clear();
+}
+
+void SweepAndPrune::update() {
+    // Refresh the cached bounds. Keeping them next to each other avoids chasing body pointers during the sweep.
+    for (auto& proxy : proxies) {
+        proxy.min = proxy.body->aggregateBoundingBox.min;
+        proxy.max = proxy.body->aggregateBoundingBox.max;
+        proxy.awake = proxy.body->mass < FLT_MAX && !proxy.body->sleeping;
+    }
+
+    insertionSort();
+
+    awakeOrder.clear();
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (proxies[order[i]].awake) awakeOrder.push_back(static_cast<uint32_t>(i));
+    }
+
+    // Awake proxies sweep over everything after them, resting ones only over the awake ones after them.
+    // Either way the pairs come out in the same order as a full sweep would emit them.
+    pairs.clear();
+    size_t nextAwake = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Proxy& a = proxies[order[i]];
+        while (nextAwake < awakeOrder.size() && awakeOrder[nextAwake] <= i) ++nextAwake;
+
+        if (a.awake) {
+            for (size_t j = i + 1; j < order.size(); ++j) {
+                // Everything after this starts further along x than a ends
+                if (proxies[order[j]].min.x > a.max.x) break;
+                emit(order[i], order[j]);
+            }
+        } else {
+            for (size_t k = nextAwake; k < awakeOrder.size(); ++k) {
+                uint32_t j = order[awakeOrder[k]];
+                if (proxies[j].min.x > a.max.x) break;
+                emit(order[i], j);
+            }
+        }
+    }
+}
+
+void SweepAndPrune::emit(uint32_t first, uint32_t second) {
+    const Proxy& a = proxies[first];
+    const Proxy& b = proxies[second];
+    if (a.min.y <= b.max.y && a.max.y >= b.min.y &&
+        a.min.z <= b.max.z && a.max.z >= b.min.z) {
+        // Emit in insertion order so pair orientation does not depend on the sort
+        if (first < second) {
+            pairs.emplace_back(a.body, b.body);
+        } else {
+            pairs.emplace_back(b.body, a.body);
+        }
+    }
+}
+
+void SweepAndPrune::insertionSort() {
+    // Ties go by proxy index, so the order only depends on the current bounds and not on earlier steps.
+    // A world restored from a snapshot then emits its pairs in the same order it originally did.
+    for (size_t i = 1; i < order.size(); ++i) {
+        uint32_t current = order[i];
+        float key = proxies[current].min.x;
+        size_t j = i;
+        while (j > 0 && (proxies[order[j - 1]].min.x > key ||
+                         (proxies[order[j - 1]].min.x == key && order[j - 1] > current))) {
+            order[j] = order[j - 1];
+            --j;
+        }
+        order[j] = current;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Broadphase.h"
+
+// Persistent sort-and-sweep broadphase over each body's aggregate bounds.
+// Proxies stay sorted by min.x between steps, so re-sorting is an insertion sort that is close to linear
+// when bodies only move a little per step. Only body pairs whose bounds overlap on all three axes are emitted.
+// Pairs where neither body can move (static or sleeping) are left out: resting proxies only sweep over the
+// awake ones, so a scene that is mostly asleep costs little more than the sort.
+class SweepAndPrune : public Broadphase {
+public:
+    void addBody(RigidBody* body) override;
+    void removeBody(RigidBody* body) override;
+    void clear() override;
+    void update() override;
+
+private:
+    struct Proxy {
+        RigidBody* body;
+        glm::vec3 min;
+        glm::vec3 max;
+        bool awake;
+    };
+
+    std::vector<Proxy> proxies;
+    std::vector<uint32_t> order;  // Proxy indices sorted by min.x, kept across steps
+    std::vector<uint32_t> awakeOrder;  // Positions in order of the awake proxies
+
+    void insertionSort();
+    void emit(uint32_t first, uint32_t second);
+};
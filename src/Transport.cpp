@@ -0,0 +1,29 @@
+#include "Transport.h"
+
+LoopbackPipe::LoopbackPipe(uint32_t latencyTicks, float lossPercent, unsigned seed)
+        : latencyTicks(latencyTicks), lossPercent(lossPercent), rng(seed) {
+    endpoints[0] = std::make_unique<Endpoint>(*this, 0);
+    endpoints[1] = std::make_unique<Endpoint>(*this, 1);
+}
+
+void LoopbackPipe::tick() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++now;
+}
+
+void LoopbackPipe::Endpoint::send(const uint8_t* data, size_t size) {
+    std::lock_guard<std::mutex> lock(pipe.mutex);
+    if (pipe.lossPercent > 0.0f && std::uniform_real_distribution<float>(0.0f, 100.0f)(pipe.rng) < pipe.lossPercent) {
+        return;
+    }
+    pipe.inFlight[1 - side].push_back({pipe.now + pipe.latencyTicks, std::vector<uint8_t>(data, data + size)});
+}
+
+bool LoopbackPipe::Endpoint::receive(std::vector<uint8_t>& packet) {
+    std::lock_guard<std::mutex> lock(pipe.mutex);
+    std::deque<Packet>& queue = pipe.inFlight[side];
+    if (queue.empty() || queue.front().deliverAt > pipe.now) return false;
+    packet = std::move(queue.front().data);
+    queue.pop_front();
+    return true;
+}
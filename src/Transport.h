@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+// Carries whole packets between the two peers of a RollbackSession. Packets may arrive late, out of order or
+// not at all, as they would over UDP; the session resends what was not acknowledged. Neither call blocks.
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    virtual void send(const uint8_t* data, size_t size) = 0;
+    // Moves the next packet that has arrived into packet and returns true, or returns false if none has
+    virtual bool receive(std::vector<uint8_t>& packet) = 0;
+};
+
+// Two connected in-process endpoints that stand in for the network. Time is counted in ticks, one per frame,
+// so latency and loss are the same on every run with the same seed. Endpoints may be used from two threads.
+class LoopbackPipe {
+public:
+    // A packet can be received latencyTicks ticks after it was sent. lossPercent of packets are dropped.
+    explicit LoopbackPipe(uint32_t latencyTicks, float lossPercent = 0.0f, unsigned seed = 1);
+
+    [[nodiscard]] Transport& endpoint(int side) { return *endpoints[side]; }
+    // Advances the pipe's clock. Packets that have been in flight for latencyTicks become receivable.
+    void tick();
+
+private:
+    struct Packet {
+        uint64_t deliverAt;
+        std::vector<uint8_t> data;
+    };
+
+    class Endpoint : public Transport {
+    public:
+        Endpoint(LoopbackPipe& pipe, int side) : pipe(pipe), side(side) {}
+        void send(const uint8_t* data, size_t size) override;
+        bool receive(std::vector<uint8_t>& packet) override;
+
+    private:
+        LoopbackPipe& pipe;
+        int side;
+    };
+
+    std::mutex mutex;
+    uint64_t now = 0;
+    uint32_t latencyTicks;
+    float lossPercent;
+    std::mt19937 rng;
+    std::deque<Packet> inFlight[2];  // Indexed by the receiving side, in send order
+    std::unique_ptr<Endpoint> endpoints[2];
+};
@@ -0,0 +1,55 @@
+#include <cmath>
+#include "TriangleBVH.h"
+
+namespace {
+    // Rays this close to parallel with a triangle's plane miss it
+    constexpr float kParallelEpsilon = 1e-9f;
+}
+
+void TriangleBVH::build(const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& indices) {
+    size_t count = indices.size() / 3;
+    triangles.resize(count);
+    std::vector<BoundingBox> bounds(count);
+    for (size_t i = 0; i < count; ++i) {
+        const glm::vec3& a = vertices[indices[3 * i]];
+        const glm::vec3& b = vertices[indices[3 * i + 1]];
+        const glm::vec3& c = vertices[indices[3 * i + 2]];
+        triangles[i] = {a, b - a, c - a};
+        bounds[i].update(a, b, c);
+    }
+    tree.build(bounds);
+}
+
+bool TriangleBVH::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                          TriangleHit& hit) const {
+    bool found = false;
+    tree.queryRay(origin, direction, maxDistance, [&](uint32_t index) {
+        // Möller–Trumbore: solve origin + t * direction = v0 + u * edge1 + v * edge2
+        const Triangle& tri = triangles[index];
+        glm::vec3 p = glm::cross(direction, tri.edge2);
+        float determinant = glm::dot(tri.edge1, p);
+        if (std::abs(determinant) < kParallelEpsilon) return maxDistance;
+
+        float inverse = 1.0f / determinant;
+        glm::vec3 s = origin - tri.v0;
+        float u = glm::dot(s, p) * inverse;
+        if (u < 0.0f || u > 1.0f) return maxDistance;
+
+        glm::vec3 q = glm::cross(s, tri.edge1);
+        float v = glm::dot(direction, q) * inverse;
+        if (v < 0.0f || u + v > 1.0f) return maxDistance;
+
+        float t = glm::dot(tri.edge2, q) * inverse;
+        if (t < 0.0f || t > maxDistance) return maxDistance;
+
+        maxDistance = t;
+        hit.triangle = index;
+        hit.distance = t;
+        hit.u = u;
+        hit.v = v;
+        found = true;
+        return maxDistance;
+    });
+    if (found) hit.point = origin + direction * hit.distance;
+    return found;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "BVH.h"
+
+struct TriangleHit {
+    uint32_t triangle = 0;  // Index of the triangle's first vertex index / 3
+    float distance = 0.0f;  // Ray parameter, a distance when the direction is normalized
+    glm::vec3 point{0.0f};
+    float u = 0.0f;         // Barycentric weights of the second and third vertices
+    float v = 0.0f;
+};
+
+// Ray casts against a triangle mesh, in the mesh's own space. Triangles are kept with their edges precomputed
+// for the Möller–Trumbore test at the leaves of a BVH over their bounds. Both faces count as hits.
+class TriangleBVH {
+public:
+    void build(const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& indices);
+
+    // Closest triangle the ray origin + t * direction hits with t in [0, maxDistance]
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, TriangleHit& hit) const;
+
+    [[nodiscard]] bool empty() const { return triangles.empty(); }
+    [[nodiscard]] size_t triangleCount() const { return triangles.size(); }
+
+private:
+    struct Triangle {
+        glm::vec3 v0;
+        glm::vec3 edge1;
+        glm::vec3 edge2;
+    };
+
+    BVH tree;
+    std::vector<Triangle> triangles;
+};
@@ -1,4 +1,6 @@
 #include "UI.h"
+#include <cfloat>
+#include <cstdio>
 
 inline void CenterWrappedText(float window_center_x, float wrap_width, const char* text) {
     ImVec2 textSize = ImGui::CalcTextSize(text, text + strlen(text), false, wrap_width);
@@ -19,6 +21,18 @@ inline bool CenterButton(float window_center_x, const char* label, float padding
     return ImGui::Button(label, buttonSize);
 }
 
+// Plots one value from every step in the history, with the latest value as the overlay text
+template<typename Getter>
+void PlotStepHistory(const char* label, const PhysicsStatsHistory& history, const char* overlayFormat, Getter get) {
+    float values[PhysicsStatsHistory::kCapacity];
+    for (size_t i = 0; i < history.size(); ++i) {
+        values[i] = get(history[i]);
+    }
+    char overlay[64];
+    std::snprintf(overlay, sizeof(overlay), overlayFormat, history.empty() ? 0.0f : values[history.size() - 1]);
+    ImGui::PlotLines(label, values, static_cast<int>(history.size()), 0, overlay, 0.0f, FLT_MAX, ImVec2(0, 40));
+}
+
 inline void TextWithLink(const char* text, const char* url) {
     ImVec4 linkColor = ImVec4(0.2f, 0.2f, 1.0f, 1.0f);  // Blue color
     ImGui::TextColored(linkColor, text);
@@ -161,13 +175,34 @@ void showInfoScreen(GLFWwindow *window, float (*imguiColor)[3]) {
     // Color editor
     ImGui::ColorEdit3("background color", *imguiColor);
 
-    // Plot histograms
-    float arr[] = {0.64f, 0.51f, 0.52f, 0.43f, 0.49f, 0.56f};
-    ImGui::PlotHistogram("Weights", arr, IM_ARRAYSIZE(arr), 0, nullptr, 0.0f, 1.0f, ImVec2(0, 80));
+    // Live physics step breakdown, microseconds per phase and work counts, over the last few seconds
+    PhysicsWorld* physicsWorld = data->cameraState->camera->physicsWorld;
+    if (physicsWorld && ImGui::CollapsingHeader("Physics", ImGuiTreeNodeFlags_DefaultOpen)) {
+        const PhysicsStatsHistory& history = physicsWorld->getStatsHistory();
+        auto micros = [](double seconds) { return static_cast<float>(seconds * 1e6); };
+        PlotStepHistory("Step", history, "%.0f us", [&](const PhysicsStepStats& s) { return micros(s.totalSeconds); });
+        PlotStepHistory("Integrate", history, "%.0f us", [&](const PhysicsStepStats& s) { return micros(s.integrateSeconds); });
+        PlotStepHistory("Broadphase", history, "%.0f us", [&](const PhysicsStepStats& s) { return micros(s.broadphaseSeconds); });
+        PlotStepHistory("Narrowphase", history, "%.0f us", [&](const PhysicsStepStats& s) { return micros(s.narrowphaseSeconds); });
+        PlotStepHistory("Solve", history, "%.0f us", [&](const PhysicsStepStats& s) { return micros(s.solveSeconds); });
+        PlotStepHistory("Sleep", history, "%.0f us", [&](const PhysicsStepStats& s) { return micros(s.sleepSeconds); });
+        PlotStepHistory("Pairs", history, "%.0f", [](const PhysicsStepStats& s) { return static_cast<float>(s.pairs); });
+        PlotStepHistory("Contacts", history, "%.0f", [](const PhysicsStepStats& s) { return static_cast<float>(s.contacts); });
+        PlotStepHistory("Sleeping", history, "%.0f", [](const PhysicsStepStats& s) { return static_cast<float>(s.sleeping); });
+    }
 
     // Checkbox to toggle showCamera
     ImGui::Checkbox("Bound Camera", &data->boundCamera);
 
+    // Switch broadphase on the running scene to compare them
+    if (physicsWorld) {
+        const char* broadphaseNames[] = { "Brute Force", "Sweep and Prune", "Uniform Grid" };
+        int broadphaseIndex = static_cast<int>(physicsWorld->getBroadphaseType());
+        if (ImGui::Combo("Broadphase", &broadphaseIndex, broadphaseNames, IM_ARRAYSIZE(broadphaseNames))) {
+            physicsWorld->setBroadphase(static_cast<BroadphaseType>(broadphaseIndex));
+        }
+    }
+
     // Add Menu button to go back to the Home Screen
     if (ImGui::Button("Menu")) {
         data->showHomeScreen = true;
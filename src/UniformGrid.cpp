@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cmath>
+#include "UniformGrid.h"
+
+namespace {
+    bool overlaps(const glm::vec3& minA, const glm::vec3& maxA, const glm::vec3& minB, const glm::vec3& maxB) {
+        return minA.x <= maxB.x && maxA.x >= minB.x &&
+               minA.y <= maxB.y && maxA.y >= minB.y &&
+               minA.z <= maxB.z && maxA.z >= minB.z;
+    }
+}
+
+void UniformGrid::addBody(RigidBody* body) {
+    proxies.push_back({body, body->aggregateBoundingBox.min, body->aggregateBoundingBox.max});
+}
+
+void UniformGrid::removeBody(RigidBody* body) {
+    proxies.erase(std::remove_if(proxies.begin(), proxies.end(), [&](const Proxy& proxy) { return proxy.body == body; }),
+                  proxies.end());
+}
+
+void UniformGrid::clear() {
+    proxies.clear();
+    pairs.clear();
+}
+
+glm::ivec3 UniformGrid::cellOf(const glm::vec3& p, float invCellSize) const {
+    return glm::ivec3(glm::floor(p * invCellSize));
+}
+
+uint32_t UniformGrid::hashCell(const glm::ivec3& cell, uint32_t mask) {
+    auto h = static_cast<uint32_t>(cell.x) * 73856093u ^
+             static_cast<uint32_t>(cell.y) * 19349663u ^
+             static_cast<uint32_t>(cell.z) * 83492791u;
+    return h & mask;
+}
+
+void UniformGrid::emit(uint32_t a, uint32_t b) {
+    if (a > b) std::swap(a, b);
+    pairs.emplace_back(proxies[a].body, proxies[b].body);
+}
+
+void UniformGrid::update() {
+    pairs.clear();
+    if (proxies.empty()) return;
+
+    extents.resize(proxies.size());
+    for (size_t i = 0; i < proxies.size(); ++i) {
+        Proxy& proxy = proxies[i];
+        proxy.min = proxy.body->aggregateBoundingBox.min;
+        proxy.max = proxy.body->aggregateBoundingBox.max;
+        glm::vec3 extent = proxy.max - proxy.min;
+        extents[i] = std::max(extent.x, std::max(extent.y, extent.z));
+    }
+
+    float size = cellSize;
+    if (size <= 0.0f) {
+        // Leave out anything that would be kept aside as large at a cell size picked from the median, so one
+        // stadium does not blow the cells up for every top
+        sortedExtents.assign(extents.begin(), extents.end());
+        auto middle = sortedExtents.begin() + static_cast<std::ptrdiff_t>(sortedExtents.size() / 2);
+        std::nth_element(sortedExtents.begin(), middle, sortedExtents.end());
+        float smallLimit = 2.0f * *middle * std::cbrt(static_cast<float>(std::max(maxCellsPerBody, 1)));
+
+        float totalSize = 0.0f;
+        int smallCount = 0;
+        for (float extent : extents) {
+            if (extent > smallLimit) continue;
+            totalSize += extent;
+            smallCount++;
+        }
+        size = smallCount > 0 ? 2.0f * totalSize / static_cast<float>(smallCount) : 0.0f;
+        if (size <= 0.0f) size = 1.0f;
+    }
+    float invCellSize = 1.0f / size;
+
+    // Split off bodies that span too many cells, and count the entries the rest will need
+    smallProxies.clear();
+    largeProxies.clear();
+    size_t entryCount = 0;
+    for (uint32_t i = 0; i < proxies.size(); ++i) {
+        glm::ivec3 span = cellOf(proxies[i].max, invCellSize) - cellOf(proxies[i].min, invCellSize) + 1;
+        long long cells = static_cast<long long>(span.x) * span.y * span.z;
+        if (cells > maxCellsPerBody) {
+            largeProxies.push_back(i);
+        } else {
+            smallProxies.push_back(i);
+            entryCount += static_cast<size_t>(cells);
+        }
+    }
+
+    uint32_t tableSize = 1;
+    while (tableSize < 2 * entryCount) tableSize <<= 1;
+    uint32_t mask = tableSize - 1;
+
+    // Counting sort: count per bucket, prefix sum, then scatter
+    bucketStart.assign(tableSize + 1, 0);
+    for (uint32_t index : smallProxies) {
+        glm::ivec3 lo = cellOf(proxies[index].min, invCellSize);
+        glm::ivec3 hi = cellOf(proxies[index].max, invCellSize);
+        for (int x = lo.x; x <= hi.x; ++x)
+            for (int y = lo.y; y <= hi.y; ++y)
+                for (int z = lo.z; z <= hi.z; ++z)
+                    bucketStart[hashCell({x, y, z}, mask) + 1]++;
+    }
+    for (uint32_t b = 0; b < tableSize; ++b) {
+        bucketStart[b + 1] += bucketStart[b];
+    }
+
+    entries.resize(entryCount);
+    scratchCursor.assign(bucketStart.begin(), bucketStart.end() - 1);
+    for (uint32_t index : smallProxies) {
+        glm::ivec3 lo = cellOf(proxies[index].min, invCellSize);
+        glm::ivec3 hi = cellOf(proxies[index].max, invCellSize);
+        for (int x = lo.x; x <= hi.x; ++x)
+            for (int y = lo.y; y <= hi.y; ++y)
+                for (int z = lo.z; z <= hi.z; ++z) {
+                    glm::ivec3 cell(x, y, z);
+                    entries[scratchCursor[hashCell(cell, mask)]++] = {index, cell};
+                }
+    }
+
+    // Pairs within a cell. A pair sharing several cells is only emitted by the cell holding the min corner of
+    // the overlap, and entries from other cells that hashed to the same bucket are skipped.
+    for (uint32_t b = 0; b < tableSize; ++b) {
+        for (uint32_t i = bucketStart[b]; i < bucketStart[b + 1]; ++i) {
+            const Entry& ei = entries[i];
+            const Proxy& pi = proxies[ei.proxy];
+            for (uint32_t j = i + 1; j < bucketStart[b + 1]; ++j) {
+                const Entry& ej = entries[j];
+                if (ej.cell != ei.cell) continue;
+
+                const Proxy& pj = proxies[ej.proxy];
+                if (!overlaps(pi.min, pi.max, pj.min, pj.max)) continue;
+                if (cellOf(glm::max(pi.min, pj.min), invCellSize) != ei.cell) continue;
+
+                emit(ei.proxy, ej.proxy);
+            }
+        }
+    }
+
+    // Large bodies are tested against everything else
+    for (size_t i = 0; i < largeProxies.size(); ++i) {
+        const Proxy& large = proxies[largeProxies[i]];
+        for (uint32_t index : smallProxies) {
+            if (overlaps(large.min, large.max, proxies[index].min, proxies[index].max)) {
+                emit(largeProxies[i], index);
+            }
+        }
+        for (size_t j = i + 1; j < largeProxies.size(); ++j) {
+            const Proxy& other = proxies[largeProxies[j]];
+            if (overlaps(large.min, large.max, other.min, other.max)) {
+                emit(largeProxies[i], largeProxies[j]);
+            }
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Broadphase.h"
+
+// Hashed uniform grid for many small bodies. Rebuilt from scratch every step: each body is counting-sorted into
+// the hash buckets of the cells it touches, so the rebuild is O(n) with no per-cell allocation.
+// Bodies that would touch more than maxCellsPerBody cells (like the stadium) are kept aside and tested directly.
+class UniformGrid : public Broadphase {
+public:
+    float cellSize = 0.0f;         // <= 0 picks twice the mean size of the small bodies each step, leaving out
+                                   // those far larger than the median
+    int maxCellsPerBody = 64;
+
+    void addBody(RigidBody* body) override;
+    void removeBody(RigidBody* body) override;
+    void clear() override;
+    void update() override;
+
+private:
+    struct Proxy {
+        RigidBody* body;
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    struct Entry {
+        uint32_t proxy;
+        glm::ivec3 cell;
+    };
+
+    std::vector<Proxy> proxies;
+    std::vector<float> extents;        // Largest side of each proxy's bounds
+    std::vector<float> sortedExtents;  // Scratch for the median
+    std::vector<uint32_t> smallProxies;
+    std::vector<uint32_t> largeProxies;
+    std::vector<uint32_t> bucketStart;  // Prefix sums into entries, one extra slot at the end
+    std::vector<uint32_t> scratchCursor;
+    std::vector<Entry> entries;
+
+    [[nodiscard]] glm::ivec3 cellOf(const glm::vec3& p, float invCellSize) const;
+    [[nodiscard]] static uint32_t hashCell(const glm::ivec3& cell, uint32_t mask);
+    void emit(uint32_t a, uint32_t b);
+};
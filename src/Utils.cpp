@@ -1,3 +1,4 @@
+#include <cfloat>
 #include "Utils.h"
 
 glm::vec3 screenToWorldCoordinates(GLFWwindow* window, double xpos, double ypos, const glm::mat4& view, const glm::mat4& projection) {
@@ -19,13 +20,20 @@ glm::vec3 screenToWorldCoordinates(GLFWwindow* window, double xpos, double ypos,
     return ray_wor;
 }
 
-std::string checkIntersection(const glm::vec3& ray_world) {
-    // Perform intersection test with objects in your scene and return the object name
-    // Replace this with your actual intersection logic
-    if (glm::length(ray_world - glm::vec3(0.0f, 0.0f, 0.0f)) < 1.0f) {
-        return "Object1";
+PickResult pickObject(const std::vector<GameObject*>& objects, const glm::vec3& origin, const glm::vec3& direction) {
+    PickResult result;
+    float closest = FLT_MAX;
+    for (GameObject* object : objects) {
+        TriangleHit hit;
+        if (object->raycast(origin, direction, closest, hit)) {
+            closest = hit.distance;
+            result.object = object;
+            result.triangle = hit.triangle;
+            result.point = hit.point;
+            result.distance = hit.distance;
+        }
     }
-    return "None";
+    return result;
 }
 
 void checkGLError(const char* stmt, const char* fname, int line) {
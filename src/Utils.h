@@ -8,6 +8,8 @@
 #include <sstream>
 #include <iostream>
 #include <stb_image.h>
+#include <vector>
+#include "GameObject.h"
 
 // Macro to wrap OpenGL calls for error checking
 #define GL_CHECK(stmt) do { \
@@ -17,7 +19,16 @@
 
 
 glm::vec3 screenToWorldCoordinates(GLFWwindow* window, double xpos, double ypos, const glm::mat4& view, const glm::mat4& projection);
-std::string checkIntersection(const glm::vec3& ray_world);
+
+struct PickResult {
+    GameObject* object = nullptr;  // nullptr when the ray hits nothing
+    uint32_t triangle = 0;
+    glm::vec3 point{0.0f};
+    float distance = 0.0f;
+};
+
+// Closest object whose mesh the ray from origin along direction hits
+PickResult pickObject(const std::vector<GameObject*>& objects, const glm::vec3& origin, const glm::vec3& direction);
 void checkGLError(const char* stmt, const char* fname, int line);
 void cleanup(GLFWwindow* window);
 
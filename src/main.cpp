@@ -26,14 +26,36 @@
 #include "PhysicsWorld.h"
 #include "RigidBody.h"
 #include "Beyblade.h"
+#include "DebugRenderer.h"
+#include "PhysicsClock.h"
+#include "JobSystem.h"
+#include "Replay.h"
+#include "LocalNetplay.h"
 
 #include <iomanip>
 #include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <atomic>
+#include <random>
+
+int main(int argc, char** argv) {
+    // --record FILE saves the session's physics inputs, --replay FILE plays one back instead of live input.
+    // --netplay starts a two-player match over a simulated connection, --latency FRAMES and --loss PERCENT shape it.
+    std::string recordPath, replayPath;
+    bool netplay = false;
+    uint32_t netplayLatency = 4;
+    float netplayLoss = 0.0f;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--netplay") netplay = true;
+        else if (i + 1 >= argc) break;
+        else if (arg == "--record") recordPath = argv[++i];
+        else if (arg == "--replay") replayPath = argv[++i];
+        else if (arg == "--latency") netplayLatency = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--loss") netplayLoss = std::stof(argv[++i]);
+    }
 
-int main() {
     // Window dimensions
     int windowWidth = 1600, windowHeight = 900;
     const float aspectRatio = 16.0f / 9.0f;
@@ -103,6 +125,8 @@ int main() {
     auto projection = glm::mat4(1.0f);
 
     auto physicsWorld = new PhysicsWorld;
+    JobSystem jobSystem;
+    physicsWorld->setJobSystem(&jobSystem);
 
     // Primary camera and camera state
     glm::vec3 initialCameraPos(5.0f, 5.0f, 0.0f);
@@ -121,6 +145,7 @@ int main() {
     // Time variables
     float deltaTime = 0.0f;
     float lastFrame = 0.0f;
+    PhysicsClock physicsClock(240.0f, 8);
 
     static float imguiColor[3] = {1.0f, 0.0f, 0.0f}; // Red
 
@@ -129,6 +154,7 @@ int main() {
 
 
     auto quadRenderer = new QuadRenderer();
+    DebugRenderer debugRenderer;
 
     auto identity4 = glm::mat4(1.0f);
     // Identity matrix, starting view, and projection matrices
@@ -251,10 +277,44 @@ int main() {
                     stadiumRadius, stadiumCurvature, numRings, sectionsPerRing, stadiumTexture, stadiumTextureScale, physicsWorld);
 
     GLuint Bey1VAO = 0, Bey1VBO = 0, Bey1EBO = 0;
-    auto rigidBey1 = new RigidBody(glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(1.0f), 1.0f);
+    RigidBody* rigidBey1 = physicsWorld->getBody(physicsWorld->createBody(glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(1.0f), 1.0f));
     std::string beyblade1Path = "../assets/images/beyblade.obj";
     auto bey1Position = glm::vec3(0.0f, 2.0f, 0.0f);
     Beyblade beyblade1(beyblade1Path, Bey1VAO, Bey1VBO, Bey1EBO, bey1Position, rigidBey1);
+    callbackData.pickableObjects = {&stadium, &beyblade1};
+
+    // Netplay: player one steers with I/J/K/L, player two with the arrow keys, each through their own rollback
+    // peer. The match's stadium sits at the origin, so its tops are drawn offset onto the rendered one.
+    std::unique_ptr<LocalNetplay> netplaySession;
+    std::unique_ptr<Beyblade> netplayTops[2];
+    if (netplay) {
+        MatchSettings matchSettings;
+        matchSettings.stadiumRadius = stadiumRadius;
+        matchSettings.stadiumCurvature = stadiumCurvature;
+        BeybladeConfig configs[2];
+        LaunchParameters launches[2];
+        randomLaunches(std::random_device{}(), matchSettings, configs, launches);
+        netplaySession = std::make_unique<LocalNetplay>(matchSettings, configs, launches, RollbackSettings{},
+                                                        netplayLatency, netplayLoss);
+        for (int i = 0; i < 2; ++i) {
+            netplayTops[i] = std::make_unique<Beyblade>(beyblade1Path, 0, 0, 0, stadiumPosition,
+                                                        netplaySession->getMatch().getTop(i));
+            netplayTops[i]->setRenderOffset(stadiumPosition);
+        }
+    }
+
+    // Recording and replay start from the world as it is now
+    std::unique_ptr<ReplayRecorder> replayRecorder;
+    std::unique_ptr<ReplayPlayer> replayPlayer;
+    if (!replayPath.empty()) {
+        replayPlayer = std::make_unique<ReplayPlayer>();
+        if (!replayPlayer->load(replayPath) || !replayPlayer->restoreInitialState(*physicsWorld)) {
+            replayPlayer.reset();
+        }
+    } else if (!recordPath.empty()) {
+        replayRecorder = std::make_unique<ReplayRecorder>();
+        replayRecorder->begin(*physicsWorld, 1.0f / physicsClock.getStep());
+    }
 
     /* ----------------------MAIN RENDERING LOOP-------------------------- */
 
@@ -298,7 +358,24 @@ int main() {
         } else {
             glEnable(GL_DEPTH_TEST);
 
-            physicsWorld->update(deltaTime);
+            // Run physics at a fixed rate, then place bodies between the last two steps for rendering
+            int physicsSteps = physicsClock.advance(deltaTime);
+            for (int i = 0; i < physicsSteps; ++i) {
+                if (replayPlayer) replayPlayer->applyInputs(*physicsWorld);
+                if (replayRecorder) replayRecorder->captureInputs(*physicsWorld);
+                physicsWorld->update(physicsClock.getStep());
+                if (replayRecorder) replayRecorder->endStep(*physicsWorld);
+                if (replayPlayer && !replayPlayer->diverged() && !replayPlayer->endStep(*physicsWorld)) {
+                    std::cerr << "Replay diverged after step " << replayPlayer->getDivergedStep() << std::endl;
+                }
+            }
+            physicsWorld->interpolate(physicsClock.getAlpha());
+
+            if (netplaySession) {
+                PlayerInput player1 = readPlayerInput(window, GLFW_KEY_J, GLFW_KEY_L, GLFW_KEY_I, GLFW_KEY_K);
+                PlayerInput player2 = readPlayerInput(window, GLFW_KEY_LEFT, GLFW_KEY_RIGHT, GLFW_KEY_UP, GLFW_KEY_DOWN);
+                netplaySession->advance(deltaTime, player1, player2);
+            }
 
             if(callbackData.showInfoScreen) {
                 showInfoScreen(window, &imguiColor);
@@ -331,17 +408,25 @@ int main() {
 
             // Does not need to take in lightColor and lightPos, as these should be same for all objects
 
+            // The object under the cursor is lit a little brighter
+            auto lightFor = [&](const GameObject* object) {
+                return callbackData.hover.object == object ? glm::vec3(1.4f) : glm::vec3(1.0f);
+            };
+
             // Update and render the stadium (uses this texture)
-            stadium.render(*objectShader, glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3(0.0f, 1e6f, 0.0f));
+            stadium.render(*objectShader, lightFor(&stadium), glm::vec3(0.0f, 1e6f, 0.0f));
 
-            // Update and render the Beyblade
-            beyblade1.update(deltaTime);
-            beyblade1.render(*objectShader, glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3(0.0f, 1e6f, 0.0f));
+            // Render the Beyblade, or the netplay match's two instead
+            if (netplaySession) {
+                for (auto& top : netplayTops) {
+                    top->render(*objectShader, glm::vec3(1.0f), glm::vec3(0.0f, 1e6f, 0.0f));
+                }
+            } else {
+                beyblade1.render(*objectShader, lightFor(&beyblade1), glm::vec3(0.0f, 1e6f, 0.0f));
+            }
 
             // Render bounding boxes for debugging
-            physicsWorld->renderDebug(*objectShader);
-//            mainCamera.body->renderDebug(*objectShader, cameraState->camera->Position);
-//            stadium.body->renderDebug(*objectShader, cameraState->camera->Position);
+            debugRenderer.render(*physicsWorld, *objectShader);
 
 
             // Render text overlay
@@ -350,12 +435,19 @@ int main() {
             ss << "X: " << cameraState->camera->Position.x << " "
                << "Y: " << cameraState->camera->Position.y << " "
                << "Z: " << cameraState->camera->Position.z << "   |   "
-               << "Min" << cameraState->camera->body->boundingBoxes[0]->min.x << " " <<
-                cameraState->camera->body->boundingBoxes[0]->min.y << " " <<
-                cameraState->camera->body->boundingBoxes[0]->min.z << "\n"
-                << "Max" << cameraState->camera->body->boundingBoxes[0]->max.x << " " <<
-                cameraState->camera->body->boundingBoxes[0]->max.y << " " <<
-                cameraState->camera->body->boundingBoxes[0]->max.z << "\n";
+               << "Min" << cameraState->camera->body->boundingBoxes[0].min.x << " " <<
+                cameraState->camera->body->boundingBoxes[0].min.y << " " <<
+                cameraState->camera->body->boundingBoxes[0].min.z << "\n"
+                << "Max" << cameraState->camera->body->boundingBoxes[0].max.x << " " <<
+                cameraState->camera->body->boundingBoxes[0].max.y << " " <<
+                cameraState->camera->body->boundingBoxes[0].max.z << "\n";
+            if (netplaySession) {
+                const RollbackSession& session = netplaySession->getSession(0);
+                const RollbackStats& stats = session.getStats();
+                ss << "Netplay frame " << session.getFrame() << "   |   " << stats.rollbacks << " rollbacks, worst "
+                   << stats.maxRollbackFrames << " frames in " << 1e3 * stats.maxRollbackSeconds << " ms"
+                   << (stats.desyncFrame != UINT32_MAX ? "   |   DESYNC" : "") << "\n";
+            }
             std::string cameraPosStr = ss.str();
             std::replace(cameraPosStr.begin(), cameraPosStr.end(), '-', ';');
 
@@ -375,6 +467,13 @@ int main() {
 
     /* ----------------------CLEANUP-------------------------- */
 
+    if (replayRecorder) {
+        replayRecorder->save(recordPath);
+    }
+
+    // The world owns every body, the camera's and the stadium's included
+    delete physicsWorld;
+
     // Variables cleanup
     glDeleteVertexArrays(1, &tetrahedronVAO);
     glDeleteBuffers(1, &tetrahedronVBO);